@@ -9,20 +9,97 @@
 #define INCLUDE_ALGORITHMIC_H_
 
 #include <vector>
+#include <utility>
+#include "DistanceMatrix.h"
 
 #define WEIGHTED   0
 #define DISCRETE   1
 
+#define MST_AUTO      0
+#define MST_KRUSKAL   1
+#define MST_PRIM      2
+
 using namespace std ;
 
-int poids(vector<vector<int> > graph, vector<int> solution, int type = WEIGHTED);
+int poids(const DistanceMatrix& graph, const vector<int>& solution, int type = WEIGHTED);
+int edgeCost(const DistanceMatrix& graph, int u, int v, int type = WEIGHTED);
+
+//the exact engines start from the incumbent tour, or from warmStart() when it is empty
+vector<int> bruteForce(const DistanceMatrix& graph, int type = WEIGHTED, const vector<int>& incumbent = vector<int>());
+
+vector<int> backTracking(const DistanceMatrix& graph, int type = WEIGHTED, const vector<int>& incumbent = vector<int>());
+int backTracking_(const DistanceMatrix& graph, int type, vector<int>& Sol);
+vector<pair<int, int> > spanningTree(const DistanceMatrix& graph, int engine = MST_AUTO);
+void sortEdges(const vector<int>& weight, vector<int>& order);
+vector<int> minimumSpanningTree(const DistanceMatrix& graph, int engine = MST_AUTO);
+vector<int> christofides(const DistanceMatrix& graph, int engine = MST_AUTO);
+
+#define HELDKARP_MAX 28 //largest graph solved by heldKarp, it stores (n-1) 2^(n-2) costs
+
+//empty tour, and a message on cerr, above HELDKARP_MAX vertices
+vector<int> heldKarp(const DistanceMatrix& graph, int type = WEIGHTED);
+vector<int> branchAndBound(const DistanceMatrix& graph, int type = WEIGHTED, const vector<int>& incumbent = vector<int>());
+
+//tour stored as an array plus the position of every vertex in it
+class TourArray {
+public:
+	TourArray(const vector<int>& tour) ;
+
+	int size() const { return order.size() ; }
+	int at(int i) const { return order[i] ; }
+	int position(int v) const { return pos[v] ; }
+	int next(int v) const { return order[pos[v] + 1 == (int) order.size() ? 0 : pos[v] + 1] ; }
+	int prev(int v) const { return order[pos[v] == 0 ? order.size() - 1 : pos[v] - 1] ; }
+
+	void reversePath(int x, int y) ;
+	void move(int a, int b, int c) ;
+
+private:
+	vector<int> order ;
+	vector<int> pos ;
+} ;
+
+vector<vector<int> > nearestNeighbours(const DistanceMatrix& graph, int k, int type = WEIGHTED);
+void improveTour(const DistanceMatrix& graph, TourArray& tour, const vector<vector<int> >& neighbours, int type = WEIGHTED);
+int improveTour(const DistanceMatrix& graph, vector<int>& tour, int type = WEIGHTED);
+//first incumbent of the exact engines when none is given: the MST tour improved by improveTour
+vector<int> warmStart(const DistanceMatrix& graph, int type = WEIGHTED);
+vector<int> linKernighan(const DistanceMatrix& graph, int type = WEIGHTED, int restarts = 0);
+
+#define PATHCOVER_EXACT_MAX 24 //largest graph covered exactly, the dynamic programming stores 2^n subsets
+
+//DISCRETE mode only: tour made of as few paths of graph edges as the greedy
+//search finds, or of the fewest possible with exact. exact is limited to
+//PATHCOVER_EXACT_MAX vertices, larger graphs get an empty tour and a message
+//on cerr
+vector<int> pathCover(const DistanceMatrix& graph, bool exact = false);
+
+#define HAMILTONIAN_MAX 28 //largest graph searched by hamiltonianCycle, it stores 2^(n-1) masks
+
+//DISCRETE mode: a cycle of graph edges through every vertex in tour, false
+//when there is none or when the graph has more than HAMILTONIAN_MAX vertices
+bool hamiltonianCycle(const DistanceMatrix& graph, vector<int>& tour, int threads = 0);
+
+#define SAT_LINEAR      0
+#define SAT_BINARY      1
+#define SAT_GALLOPING   2
 
-vector<int> bruteForce(vector<vector<int> > graph, int type = WEIGHTED);
+#define ENCODING_EDGES      0 //x_p,uv : edge uv at position p, O(n^5) clauses
+#define ENCODING_VERTICES   1 //x_v,p : vertex v at position p, O(n^3) literals
 
-vector<int> backTracking(vector<vector<int> > graph, int type = WEIGHTED);
-vector<int> backTracking_(vector<vector<int> > graph, int type, vector<int> A, int l, int lengthSoFar, vector<int> Sol);
-vector<int> minimumSpanningTree(vector<vector<int> > graph);
+//options of the SAT resolution (DISCRETE mode)
+struct SATOptions {
+	bool incremental ; //a single solver for every k, the bound on k is an assumption
+	int search ;       //order of the probed bounds k
+	int threads ;      //bounds probed at the same time, hardwareThreads() when <= 0
+	int upperBound ;   //cost of a known tour, -1 for the cost of warmStart
+	int lowerBound ;   //known lower bound on the cost, see reduceGraph
+	int encoding ;     //CNF formulation
+	bool symmetry ;    //symmetry breaking clauses
+	int precheck ;     //hamiltonianCycle settles k = 0 before any CNF up to this size (at most HAMILTONIAN_MAX)
+	SATOptions() : incremental(true), search(SAT_GALLOPING), threads(0), upperBound(-1), lowerBound(0), encoding(ENCODING_VERTICES), symmetry(true), precheck(20) {}
+} ;
 
-int SAT(vector<vector<int> > graph) ;
+int SAT(const DistanceMatrix& graph, const SATOptions& options = SATOptions()) ;
 
 #endif /* INCLUDE_ALGORITHMIC_H_ */
@@ -0,0 +1,127 @@
+/*
+ * Benchmark.h
+ *
+ *  Sweeps of the solvers over random instances, described by a
+ *  configuration file.
+ */
+
+#ifndef INCLUDE_BENCHMARK_H_
+#define INCLUDE_BENCHMARK_H_
+
+#include <map>
+#include <string>
+#include <vector>
+#include "DistanceMatrix.h"
+#include "Algorithmic.h"
+#include "Random.h"
+
+using namespace std ;
+
+#define TRIAL_OK        0
+#define TRIAL_TIMEOUT   1 //killed after the timeout of its algorithm
+#define TRIAL_FAILED    2 //the process running it crashed, or the algorithm refused the graph
+
+#define PIN_NONE        0 //trials run on any core
+#define PIN_CORES       1 //each running trial has its own cores
+
+struct BenchmarkConfig {
+	int mode ;                    //DISCRETE or WEIGHTED
+	vector<string> algorithms ;   //names of the command line (brute, bt, mst, ...)
+	vector<int> sizes ;
+	string generator ;            //DISCRETE: gnp, gnm or geometric, WEIGHTED: uniform or euclidean
+	double density ;              //DISCRETE: probability of an edge
+	int weightFactor ;            //WEIGHTED: weights in [1, weightFactor * n]
+	int repetitions ;             //timed trials per algorithm and size, on as many instances
+	int warmup ;                  //untimed runs before each timed trial, in its process
+	double timeout ;              //seconds per trial, 0 for none
+	map<string, double> timeouts ; //per algorithm, overrides timeout
+	int jobs ;                    //trials run at the same time, 0 for one per core
+	int pin ;                     //PIN_NONE or PIN_CORES
+	string results ;              //file the trials are appended to, none when empty
+	uint64_t seed ;               //base seed of the instances, a fresh one by default
+	string corpus ;               //directory the instances are loaded from, generated when empty
+	BenchmarkConfig() : mode(DISCRETE), generator("gnp"), density(0.6), weightFactor(10), repetitions(10), warmup(0), timeout(60), jobs(1), pin(PIN_NONE), seed(freshSeed()) {}
+} ;
+
+struct TrialResult {
+	int status ;
+	double wall ; //seconds, steady clock
+	double cpu ;  //seconds, user + system time of every thread
+	long maxRss ; //kB, peak resident set size of the trial process
+	int cost ;
+} ;
+
+struct Trial {
+	string algorithm ;
+	const DistanceMatrix* graph ;
+	double timeout ; //seconds per run, 0 for no limit
+	int warmup ;     //untimed runs on the graph before the timed one
+	Trial() : graph(NULL), timeout(0), warmup(0) {}
+} ;
+
+/* key = value lines, the text after # is ignored:
+ *   mode = discrete               (or weighted)
+ *   generator = gnm               (gnp by default, uniform for weighted)
+ *   algorithms = mst, lk, sat
+ *   sizes = 10:100:10             (first:last:step, or a list 10, 20, 50)
+ *   density = 0.6
+ *   weight = 10
+ *   repetitions = 10
+ *   warmup = 1
+ *   timeout = 60
+ *   timeout.brute = 10
+ *   jobs = 4                      (0 for one per core)
+ *   pin = cores                   (or none)
+ *   results = runs.csv            (or runs.jsonl)
+ *   seed = 42
+ *   corpus = instances            (directory written by writeCorpus)
+ * The corpus is not read here: the same file can write it with ./SATan
+ * corpus and run on it afterwards. Prints the offending line on cerr and
+ * returns false on an error.
+ */
+bool readBenchmarkConfig(const char* fileName, BenchmarkConfig& config) ;
+
+/* sweep of "./SATan mode algorithm" */
+BenchmarkConfig defaultBenchmark(int mode, const string& algorithm) ;
+
+bool knownAlgorithm(const string& name, int mode) ;
+
+/* seed of the instance of size n for the repetition */
+uint64_t instanceSeed(const BenchmarkConfig& config, int n, int repetition) ;
+
+bool knownGenerator(const string& name, int mode) ;
+
+/* instance of size n for the repetition, generated from its seed. With the
+ * density p, gnm has p n (n - 1) / 2 edges and geometric the radius
+ * sqrt(p / pi), close to the same expected density; the weights of uniform
+ * and the side of the square of euclidean are weight * n.
+ */
+DistanceMatrix benchmarkInstance(const BenchmarkConfig& config, int n, int repetition) ;
+
+/* cost of the tour found by the algorithm, -1 when it refuses the graph */
+int runAlgorithm(const string& name, const DistanceMatrix& graph, int mode) ;
+
+/* runs each trial in a child process, at most jobs at the same time, in
+ * its own temporary directory which is removed afterwards. The warmup runs
+ * happen in the same process, before the clock starts. A trial is killed
+ * after its timeout, counted once for each of its runs. With PIN_CORES the cores of the process are split
+ * between the jobs and each trial only runs on the cores of its job. The
+ * results are in the order of the trials.
+ */
+vector<TrialResult> runTrials(const vector<Trial>& trials, int mode, int jobs = 1, int pin = PIN_NONE) ;
+
+/* a single trial, killed after timeout seconds (0 for no limit) */
+TrialResult runTrial(const string& name, const DistanceMatrix& graph, int mode, double timeout) ;
+
+/* every size is run on the same instances by every algorithm, the trials of
+ * a size are run together by runTrials. An algorithm is dropped for the
+ * larger sizes once a trial has timed out. The
+ * statistics of the wall-clock times are printed and written to the files
+ * mode_algorithm, every timed trial is appended to the results file. The
+ * instances come from the corpus when there is one, its manifest replaces
+ * mode, generator, density, weight and seed; false when it or one of its
+ * instances cannot be loaded.
+ */
+bool runBenchmark(const BenchmarkConfig& config) ;
+
+#endif /* INCLUDE_BENCHMARK_H_ */
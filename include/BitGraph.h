@@ -0,0 +1,67 @@
+/*
+ * BitGraph.h
+ *
+ *  Adjacency of the graph edges (weight 1) of a DISCRETE matrix as rows of
+ *  64-bit words.
+ */
+
+#ifndef INCLUDE_BITGRAPH_H_
+#define INCLUDE_BITGRAPH_H_
+
+#include <vector>
+#include <stdint.h>
+#include "DistanceMatrix.h"
+
+using namespace std ;
+
+/* row(u) holds one bit per vertex, bit v of word v/64 is set when uv is a
+ * graph edge. The bits past n are always 0 so that rows can be combined
+ * word by word.
+ */
+class BitGraph {
+public:
+	BitGraph(const DistanceMatrix& graph) : n(graph.size()), nbWords((graph.size() + 63) / 64), bits((size_t) n * nbWords, 0) {
+		for(int u = 0 ; u < n ; u++)
+			for(int v = 0 ; v < n ; v++)
+				if(u != v && graph(u, v) != 10)
+					bits[(size_t) u * nbWords + v / 64] |= (uint64_t) 1 << (v % 64) ;
+	}
+
+	int size() const { return n ; }
+	int words() const { return nbWords ; }
+	const uint64_t* row(int u) const { return &bits[(size_t) u * nbWords] ; }
+	bool edge(int u, int v) const { return (row(u)[v / 64] >> (v % 64)) & 1 ; }
+
+	//number of neighbours of u in the set 'in' (nbWords words)
+	int degree(int u, const uint64_t* in) const {
+		const uint64_t* r = row(u) ;
+		int res = 0 ;
+		for(int w = 0 ; w < nbWords ; w++)
+			res += __builtin_popcountll(r[w] & in[w]) ;
+		return res ;
+	}
+
+	//first neighbour of u in the set 'in', -1 if there is none
+	int firstNeighbour(int u, const uint64_t* in) const {
+		const uint64_t* r = row(u) ;
+		for(int w = 0 ; w < nbWords ; w++)
+			if(r[w] & in[w])
+				return w * 64 + __builtin_ctzll(r[w] & in[w]) ;
+		return -1 ;
+	}
+
+private:
+	int n ;
+	int nbWords ;
+	vector<uint64_t> bits ;
+} ;
+
+/* dynamic programming over the subsets of vertices, with 'threads' workers
+ * (hardwareThreads() when <= 0). hamiltonianCycle stores 2^(n-1) masks and
+ * returns false above HAMILTONIAN_MAX vertices, minimumPathCover stores 2^n
+ * masks and needs n <= PATHCOVER_EXACT_MAX (both limits in Algorithmic.h).
+ */
+bool hamiltonianCycle(const BitGraph& g, vector<int>& tour, int threads = 0) ;
+vector<int> minimumPathCover(const BitGraph& g, int threads = 0) ;
+
+#endif /* INCLUDE_BITGRAPH_H_ */
@@ -0,0 +1,49 @@
+/*
+ * Corpus.h
+ *
+ *  Benchmark instances written once to a directory, named by their content
+ *  hash, and loaded back for later runs.
+ */
+
+#ifndef INCLUDE_CORPUS_H_
+#define INCLUDE_CORPUS_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "DistanceMatrix.h"
+#include "Benchmark.h"
+
+using namespace std ;
+
+#define CORPUS_MANIFEST "MANIFEST"
+
+struct CorpusEntry {
+	int n ;
+	int repetition ;
+	uint64_t seed ; //of the instance
+	uint64_t hash ; //graphHash of the instance
+	string file ;   //in the corpus directory
+} ;
+
+/* FNV-1a over the size and the weights of the graph */
+uint64_t graphHash(const DistanceMatrix& graph) ;
+
+/* generates the instance of every size and repetition of the configuration,
+ * in parallel, into files of the directory named by their hash (equal
+ * instances share one file), and lists them with the generation parameters
+ * in the manifest. False when a file cannot be written.
+ */
+bool writeCorpus(const BenchmarkConfig& config, const char* directory) ;
+
+/* reads the manifest of the directory: the mode, generator, density, weight
+ * and seed of the corpus replace those of config
+ */
+bool readCorpus(const char* directory, BenchmarkConfig& config, vector<CorpusEntry>& entries) ;
+
+/* false when the file of the entry is missing or its graph does not match
+ * the hash
+ */
+bool loadInstance(const char* directory, const CorpusEntry& entry, DistanceMatrix& graph) ;
+
+#endif /* INCLUDE_CORPUS_H_ */
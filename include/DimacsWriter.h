@@ -0,0 +1,51 @@
+/*
+ * DimacsWriter.h
+ *
+ *  Streaming DIMACS output for the CNF encodings.
+ */
+
+#ifndef INCLUDE_DIMACSWRITER_H_
+#define INCLUDE_DIMACSWRITER_H_
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "SATEncoding.h"
+
+#define DIMACS_FILE     0 //target is a file name
+#define DIMACS_GZIP     1 //target is a file name, written gzip compressed
+#define DIMACS_PIPE     2 //target is a shell command reading the CNF on its input
+
+#define DIMACS_BUFFER   (1 << 22) //bytes kept before writing to the target
+
+/* DIMACS text formatted by hand into a large reusable buffer, which is
+ * only written out when it is full (never once per clause) and on
+ * destruction. The target is a file, a gzip file, a pipe or a string.
+ */
+class DimacsWriter : public ClauseSink {
+public:
+	DimacsWriter(const char* target, int mode = DIMACS_FILE) ;
+	DimacsWriter(string& memory) ;
+	~DimacsWriter() ;
+
+	bool good() const { return ok ; }
+	void begin(int nbVar, long nbClauses) ;
+	void addClause(const vector<int>& clause) ;
+	void flush() ;
+	/* flushes and closes the target, false if anything failed to be written */
+	bool close() ;
+
+private:
+	int mode ;
+	bool ok ;
+	FILE* file ;
+	void* gz ;
+	string* memory ;
+	vector<char> buffer ;
+	size_t used ;
+
+	DimacsWriter(const DimacsWriter&) ;
+	DimacsWriter& operator=(const DimacsWriter&) ;
+} ;
+
+#endif /* INCLUDE_DIMACSWRITER_H_ */
@@ -0,0 +1,68 @@
+/*
+ * DistanceMatrix.h
+ *
+ *  Flat storage for the complete weighted graphs handled by SATan.
+ */
+
+#ifndef INCLUDE_DISTANCEMATRIX_H_
+#define INCLUDE_DISTANCEMATRIX_H_
+
+#include <stdint.h>
+#include <cstddef>
+
+#define MATRIX_ALIGNMENT 64
+
+enum ElementWidth { WIDTH8, WIDTH16, WIDTH32 };
+
+/* narrowest element width able to hold every weight in [0, maxWeight] */
+ElementWidth widthFor(int maxWeight) ;
+
+/* n x n matrix stored row-major in a single 64-byte aligned buffer.
+ * Every row is padded to a multiple of MATRIX_ALIGNMENT bytes so that
+ * row(i) is itself aligned and can be scanned with vector instructions.
+ * The weights must fit in the element width chosen at construction.
+ */
+class DistanceMatrix {
+public:
+	DistanceMatrix() ;
+	DistanceMatrix(int n, ElementWidth width, int fill = 0) ;
+	DistanceMatrix(const DistanceMatrix& other) ;
+	DistanceMatrix(DistanceMatrix&& other) ;
+	DistanceMatrix& operator=(DistanceMatrix other) ;
+	~DistanceMatrix() ;
+
+	int size() const { return n ; }
+	int stride() const { return rowStride ; }
+	ElementWidth width() const { return elemWidth ; }
+
+	inline int operator()(int i, int j) const {
+		size_t k = (size_t) i * rowStride + j ;
+		switch(elemWidth) {
+		case WIDTH8 :
+			return ((const uint8_t*) data)[k] ;
+		case WIDTH16 :
+			return ((const uint16_t*) data)[k] ;
+		default :
+			return ((const int32_t*) data)[k] ;
+		}
+	}
+
+	void set(int i, int j, int weight) ;
+	int maxWeight() const ;
+
+	template<typename Weight>
+	const Weight* row(int i) const { return (const Weight*) data + (size_t) i * rowStride ; }
+	const uint8_t* row8(int i) const { return (const uint8_t*) data + (size_t) i * rowStride ; }
+	const uint16_t* row16(int i) const { return (const uint16_t*) data + (size_t) i * rowStride ; }
+	const int32_t* row32(int i) const { return (const int32_t*) data + (size_t) i * rowStride ; }
+
+	friend void swap(DistanceMatrix& a, DistanceMatrix& b) ;
+
+private:
+	int n ;
+	int rowStride ;
+	ElementWidth elemWidth ;
+	void* data ;
+} ;
+
+#endif /* INCLUDE_DISTANCEMATRIX_H_ */
@@ -0,0 +1,33 @@
+/*
+ * Generators.h
+ *
+ *  Random instances built in process, straight into a DistanceMatrix.
+ */
+
+#ifndef INCLUDE_GENERATORS_H_
+#define INCLUDE_GENERATORS_H_
+
+#include <cstdint>
+#include "DistanceMatrix.h"
+
+/* DISCRETE instances: weight 1 for an edge, 10 otherwise */
+
+/* G(n, p): each edge with probability p, drawn by skipping a geometric
+ * number of non-edges, O(n + m) draws
+ */
+DistanceMatrix gnp(int n, double p, uint64_t seed) ;
+
+/* G(n, m): m distinct edges chosen uniformly */
+DistanceMatrix gnm(int n, long long m, uint64_t seed) ;
+
+/* n points uniform in the unit square, an edge between two points closer
+ * than radius; the points are bucketed in cells of side radius
+ */
+DistanceMatrix randomGeometric(int n, double radius, uint64_t seed) ;
+
+/* WEIGHTED instance: n points uniform in a square of the given side, the
+ * weights are their distances rounded to the nearest integer, at least 1
+ */
+DistanceMatrix euclidean(int n, int side, uint64_t seed) ;
+
+#endif /* INCLUDE_GENERATORS_H_ */
@@ -0,0 +1,23 @@
+/*
+ * Parallel.h
+ *
+ *  Small helpers to spread independent tasks over the available cores.
+ */
+
+#ifndef INCLUDE_PARALLEL_H_
+#define INCLUDE_PARALLEL_H_
+
+#include <functional>
+
+/* number of worker threads to use: the cores the process may run on, at
+ * least 1
+ */
+int hardwareThreads() ;
+
+/* runs body(task, worker) for every task in [0, count) on 'threads' workers
+ * (hardwareThreads() when threads <= 0). Tasks are handed out dynamically,
+ * worker is in [0, threads) and identifies the thread running the task.
+ */
+void parallelFor(int count, const std::function<void(int, int)>& body, int threads = 0) ;
+
+#endif /* INCLUDE_PARALLEL_H_ */
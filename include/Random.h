@@ -0,0 +1,84 @@
+/*
+ * Random.h
+ *
+ *  Seeded pseudo-random numbers: xoshiro256** streams whose seeds are
+ *  derived from a base seed and counters.
+ */
+
+#ifndef INCLUDE_RANDOM_H_
+#define INCLUDE_RANDOM_H_
+
+#include <chrono>
+#include <cstdint>
+#include <random>
+
+/* splitmix64 step, spreads any seed over a well mixed state */
+inline uint64_t splitMix64(uint64_t& state) {
+	uint64_t z = (state += 0x9E3779B97F4A7C15ULL) ;
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL ;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL ;
+	return z ^ (z >> 31) ;
+}
+
+/* seed of the stream (a, b) of the base seed, a function of the three values
+ * only: streams can be created in any order, or on any thread. The result
+ * fits in 63 bits.
+ */
+inline uint64_t deriveSeed(uint64_t seed, uint64_t a, uint64_t b = 0) {
+	uint64_t state = seed ;
+	state = splitMix64(state) ^ a ;
+	state = splitMix64(state) ^ b ;
+	return splitMix64(state) >> 1 ;
+}
+
+/* a seed which differs from one call, and one run, to the next */
+inline uint64_t freshSeed() {
+	std::random_device device ;
+	uint64_t state = ((uint64_t) device() << 32) ^ device() ^ (uint64_t) std::chrono::steady_clock::now().time_since_epoch().count() ;
+	return splitMix64(state) >> 1 ;
+}
+
+/* xoshiro256** of Blackman and Vigna */
+class Random {
+public:
+	Random(uint64_t seed) {
+		for(int i = 0 ; i < 4 ; i++)
+			s[i] = splitMix64(seed) ;
+	}
+
+	uint64_t next() {
+		uint64_t res = rotl(s[1] * 5, 7) * 9 ;
+		uint64_t t = s[1] << 17 ;
+		s[2] ^= s[0] ;
+		s[3] ^= s[1] ;
+		s[1] ^= s[2] ;
+		s[0] ^= s[3] ;
+		s[2] ^= t ;
+		s[3] = rotl(s[3], 45) ;
+		return res ;
+	}
+
+	/* uniform in [0, 1) */
+	double uniform() {
+		return (next() >> 11) * (1.0 / 9007199254740992.0) ;
+	}
+
+	/* uniform in [0, bound), without modulo bias */
+	uint64_t below(uint64_t bound) {
+		uint64_t threshold = -bound % bound ;
+		uint64_t r ;
+		do
+			r = next() ;
+		while(r < threshold) ;
+		return r % bound ;
+	}
+
+private:
+	static uint64_t rotl(uint64_t x, int k) {
+		return (x << k) | (x >> (64 - k)) ;
+	}
+
+	uint64_t s[4] ;
+} ;
+
+#endif /* INCLUDE_RANDOM_H_ */
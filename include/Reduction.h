@@ -0,0 +1,43 @@
+/*
+ * Reduction.h
+ *
+ *  Preprocessing of the DISCRETE instances: smaller graph with the same
+ *  optimal number of heavy edges, up to a base cost.
+ */
+
+#ifndef INCLUDE_REDUCTION_H_
+#define INCLUDE_REDUCTION_H_
+
+#include <vector>
+#include "DistanceMatrix.h"
+
+using namespace std ;
+
+/* the optimal cost of the original graph is baseCost plus the optimal cost
+ * of the reduced one, and at least lowerBound
+ */
+struct GraphReduction {
+	DistanceMatrix graph ;
+	int baseCost ;
+	int lowerBound ;
+	vector<vector<int> > members ; //original vertices of each reduced vertex, along their forced path
+	vector<vector<int> > removed ; //paths of original vertices left out, each one costs a heavy edge
+} ;
+
+/* - a vertex with r > 2 neighbours of degree 1 keeps 2 of them, the others
+ *   are paths on their own;
+ * - of several isolated vertices only one is kept;
+ * - a path of vertices of degree 2 is always followed by an optimal tour,
+ *   it becomes a single vertex.
+ * The rules are applied again on the reduced graph until it stops
+ * shrinking. The lower bound counts the vertices of degree 0 and 1, the
+ * connected components and the components left by removing a cut vertex.
+ */
+GraphReduction reduceGraph(const DistanceMatrix& graph) ;
+
+/* tour of the original graph costing at most baseCost more than the given
+ * tour of the reduced graph
+ */
+vector<int> expandTour(const DistanceMatrix& graph, const GraphReduction& reduction, const vector<int>& tour) ;
+
+#endif /* INCLUDE_REDUCTION_H_ */
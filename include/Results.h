@@ -0,0 +1,58 @@
+/*
+ * Results.h
+ *
+ *  Append-only store of the benchmark trials, and comparison of two stores.
+ */
+
+#ifndef INCLUDE_RESULTS_H_
+#define INCLUDE_RESULTS_H_
+
+#include <string>
+#include <vector>
+
+using namespace std ;
+
+#ifndef SATAN_BUILD
+#define SATAN_BUILD "unknown" //set by the Makefile from git describe
+#endif
+
+#define COMPARE_ALPHA     0.01 //significance level of the comparison
+#define COMPARE_MIN_RATIO 1.05 //smaller slowdowns of the median are ignored
+
+/* one timed trial */
+struct ResultRecord {
+	string build ;
+	string mode ;
+	string algorithm ;
+	int n ;
+	double density ;
+	int weight ;
+	long long seed ;  //of the instance, -1 when unknown
+	int repetition ;
+	string status ;   //ok, timeout or failed
+	double wall ;     //seconds
+	double cpu ;      //seconds
+	long maxRss ;     //kB
+	int cost ;
+	string generator ; //empty in files written before it was recorded
+} ;
+
+/* appends the records to a CSV file, or a JSON lines file when its name
+ * ends with .jsonl. The CSV header is written when the file is empty.
+ */
+bool appendResults(const char* fileName, const vector<ResultRecord>& records) ;
+
+/* reads back a file written by appendResults */
+bool readResults(const char* fileName, vector<ResultRecord>& records) ;
+
+/* groups the completed trials by mode, generator, algorithm, size, density
+ * and weight, and compares the wall-clock times of the groups found in both
+ * files with a one-sided Mann-Whitney U test. A group is a regression when the
+ * candidate is slower with p < alpha and a median at least
+ * COMPARE_MIN_RATIO times larger, or when it has timeouts and the base has
+ * none. Prints a line per group and returns the number of regressions, -1
+ * when a file cannot be read.
+ */
+int compareResults(const char* base, const char* candidate, double alpha = COMPARE_ALPHA) ;
+
+#endif /* INCLUDE_RESULTS_H_ */
@@ -0,0 +1,64 @@
+/*
+ * SATEncoding.h
+ *
+ *  CNF encodings of the Hamiltonian cycle problem and the clause sinks
+ *  receiving them.
+ */
+
+#ifndef INCLUDE_SATENCODING_H_
+#define INCLUDE_SATENCODING_H_
+
+#include <vector>
+#include "DistanceMatrix.h"
+#include "Algorithmic.h"
+
+using namespace std ;
+
+/* receives the clauses of an encoding, variables are numbered from 1 and a
+ * negative literal is a negated variable (DIMACS convention)
+ */
+class ClauseSink {
+public:
+	virtual ~ClauseSink() {}
+	virtual void begin(int nbVar, long nbClauses) = 0 ;
+	virtual void addClause(const vector<int>& clause) = 0 ;
+} ;
+
+/* a variable which, when true, puts the edge uv in the cycle */
+struct EdgeLiteral {
+	int var, u, v ;
+} ;
+
+/* variables of an encoding that the solvers drive */
+struct HamiltonianEncoding {
+	int n ;
+	int formulation ;
+	int nbVar ;
+	long nbClauses ;
+	vector<int> atLeast ; //atLeast[j] is true when the cycle has at least j+1 edges of weight 10
+	vector<EdgeLiteral> edges ; //ENCODING_EDGES only
+} ;
+
+/* tour of a model, model[var] being the value of the variable var */
+vector<int> decodeTour(const HamiltonianEncoding& encoding, const vector<bool>& model) ;
+
+/* Hamiltonian cycle in the given formulation, the edges of weight 10 are
+ * counted by a totalizer. With 0 <= k < n the unit clause -atLeast[k]
+ * bounds the cycle to at most k of them, otherwise the bound is left to the
+ * caller (incremental solving under assumptions). With symmetry, static
+ * clauses keep one tour out of the 2n rotations and reflections of each
+ * cycle, and (vertex formulation) order the interchangeable vertices; they
+ * do not depend on k.
+ */
+HamiltonianEncoding encodeHamiltonian(const DistanceMatrix& graph, ClauseSink& sink, int k = -1, int formulation = ENCODING_VERTICES, bool symmetry = true) ;
+
+/* classes of vertices that can be swapped without changing any tour cost */
+vector<vector<int> > twinClasses(const DistanceMatrix& graph) ;
+
+/* cardinality constraints, the auxiliary variables are taken from nextVar */
+long sequentialCounterClauses(int size, int k) ;
+void sequentialCounter(const vector<int>& lits, int k, int& nextVar, ClauseSink& sink) ;
+void totalizerSize(int size, int& nbVar, long& nbClauses) ;
+vector<int> totalizer(const vector<int>& lits, int& nextVar, ClauseSink& sink) ;
+
+#endif /* INCLUDE_SATENCODING_H_ */
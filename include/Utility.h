@@ -8,27 +8,44 @@
 #ifndef INCLUDE_UTILITY_H_
 #define INCLUDE_UTILITY_H_
 
+#include <cstdint>
+#include <string>
 #include <vector>
+#include "DistanceMatrix.h"
+#include "Algorithmic.h"
 
 using namespace std ;
 
 #define SIMPLE 0
 #define Matrix 1
 
-enum Algorithms { BRUTE, BT, MST, sat };
+enum Algorithms { BRUTE, BT, MST, sat, DP, BNB, CHRISTOFIDES, MST2OPT, LK, PATHCOVER, PATHCOVER_EXACT };
 enum Modes { WEIGHTEDMODE, DISCRETEMODE };
 
-vector<vector<int> > readGraphFromMatrix(char* fileName) ;
+DistanceMatrix readGraphFromMatrix(const char* fileName) ;
 
-vector<vector<int> > readGraphFromAdjList(char* fileName) ;
+DistanceMatrix readGraphFromAdjList(const char* fileName) ;
 
-vector<vector<int> > generateRandomGraph(int n, int maxWeight = 10) ;
+/* complete graph, weights uniform in [1, maxWeight] */
+DistanceMatrix generateRandomGraph(int n, int maxWeight, uint64_t seed) ;
 
-vector<vector<int> > generateGraph(int n, float p);
+/* G(n, p), DISCRETE weights */
+DistanceMatrix generateGraph(int n, float p, uint64_t seed);
+
+/* $TMPDIR, or /tmp when it is not set */
+string tempDirectory() ;
 
 void writeResult(const char* fileName, vector<double> t, vector<int> n, const char* fct);
-void writeGraph(const char* fileName, vector<vector<int> > graph) ;
+/* in the format of readGraphFromMatrix, false with a message on cerr when
+ * the file cannot be written
+ */
+bool writeGraph(const char* fileName, const DistanceMatrix& graph) ;
 
-void graphToSAT(const char* fileName, vector<vector<int> > graph, int k);
+/* writes the CNF of encodeHamiltonian to the target: a file, gzip compressed
+ * when its name ends with .gz, "|command" for the input of a shell command,
+ * or "-" for the standard output. False, with a message on cerr, when the
+ * target cannot be opened or written.
+ */
+bool graphToSAT(const char* target, const DistanceMatrix& graph, int k, int formulation = ENCODING_VERTICES, bool symmetry = true);
 
 #endif /* INCLUDE_UTILITY_H_ */
\ No newline at end of file
@@ -6,28 +6,35 @@
 #include <iostream>
 #include <fstream>
 #include <string.h>
+#include <climits>
+#include <atomic>
+#include <algorithm>
+#include <stdint.h>
+#include "../include/Parallel.h"
 
 #define WEIGHTED   0
 #define DISCRETE   1
 
+#define MATCHING_CANDIDATES 10 //nearest odd vertices considered by the greedy matching
 
-int poids(vector<vector<int> > graph, vector<int> solution, int type){
+
+int poids(const DistanceMatrix& graph, const vector<int>& solution, int type){
 	int res = 0 ;
 	int index = graph.size() - 1;
 
 	if(type == WEIGHTED) {
 		for(int i = 0 ; i < index ; i++) {
-			res += graph[solution[i]][solution[i+1]] ;
+			res += graph(solution[i], solution[i+1]) ;
 		}
-		return res + graph[solution[index]][solution[0]] ;
+		return res + graph(solution[index], solution[0]) ;
 	} 
 	else {
 		for(int i = 0 ; i < index ; i++) {
-			if( graph[solution[i]][solution[i+1]] == 10 ) {
+			if( graph(solution[i], solution[i+1]) == 10 ) {
 				res += 1 ;
 			}
 		}
-		if(graph[solution[index]][solution[0]] == 10 ) {
+		if(graph(solution[index], solution[0]) == 10 ) {
 			return res + 1 ;
 		}
 		else
@@ -35,45 +42,122 @@ int poids(vector<vector<int> > graph, vector<int> solution, int type){
 	}
 }
 
+int edgeCost(const DistanceMatrix& graph, int u, int v, int type) {
+	if(type == WEIGHTED)
+		return graph(u, v) ;
+	return graph(u, v) == 10 ? 1 : 0 ;
+}
+
 void swap(vector<int> *solution, int i, int j){
 	int tmp = (*solution)[i] ;
 	(*solution)[i] = (*solution)[j] ;
 	(*solution)[j] = tmp ;
 }
 
+//cost of the (at most four) edges of the tour incident to positions x and y
+int touchedCost(const DistanceMatrix& graph, const vector<int>& solution, int x, int y, int type) {
+	int n = solution.size() ;
+	int edges[4] = { (x + n - 1) % n, x, (y + n - 1) % n, y } ;
+	int res = 0 ;
+	for(int k = 0 ; k < 4 ; k++) {
+		bool seen = false ;
+		for(int l = 0 ; l < k ; l++)
+			if(edges[l] == edges[k])
+				seen = true ;
+		if(!seen)
+			res += edgeCost(graph, solution[edges[k]], solution[(edges[k] + 1) % n], type) ;
+	}
+	return res ;
+}
+
 long int factorielle(long int n) {
 	if(n <= 1)
 		return 1 ;
 	return n * factorielle(n-1) ;
 }
 
-vector<int> bruteForce(vector<vector<int> > graph, int type){
+//Parallel brute force: vertex 0 stays in position 0 and every task fixes the
+//vertices in positions 1, 2 and n-1, the remaining ones are enumerated with
+//Quickperm. A tour and its mirror image have the same cost, so only the tasks
+//whose vertex in position 1 is smaller than the one in position n-1 are run.
+vector<int> bruteForce(const DistanceMatrix& graph, int type, const vector<int>& incumbent){
 	int n = graph.size() ;
-	vector<int> solution (n);
 	vector<int> bestSol (n);
+	for (int i = 0; i < n ; i++)
+		bestSol[i] = i;
+	if(n <= 3)
+		return bestSol ;
+	bestSol = incumbent.empty() ? warmStart(graph, type) : incumbent ;
 
-	vector<int> p (n-1);
-	for (int i = 0; i < n -1 ; i++)
-		p[i] = solution[i] = bestSol[i] = i;
-	solution[n-1] = bestSol[n-1] = n-1 ;
-	int min = poids(graph, solution, type);
+	//tasks are the triples (a, b, c) with a < c, put in positions 1, 2 and n-1
+	vector<int> tasks ;
+	for(int a = 1 ; a < n ; a++)
+		for(int c = a + 1 ; c < n ; c++)
+			for(int b = 1 ; b < n ; b++)
+				if(b != a && b != c) {
+					tasks.push_back(a) ;
+					tasks.push_back(b) ;
+					tasks.push_back(c) ;
+				}
+
+	//best-so-far bound shared by all the workers, each worker keeps its own best tour
+	atomic<int> best (poids(graph, bestSol, type)) ;
+	int threads = hardwareThreads() ;
+	vector<int> workerCost (threads, INT_MAX) ;
+	vector<vector<int> > workerSol (threads) ;
+
+	parallelFor(tasks.size() / 3, [&](int task, int w) {
+		int a = tasks[3*task], b = tasks[3*task+1], c = tasks[3*task+2] ;
+		int fixedCost = edgeCost(graph, 0, a, type) + edgeCost(graph, a, b, type) + edgeCost(graph, c, 0, type) ;
+		if(fixedCost >= best.load())
+			return ;
 
-	unsigned int i = 1 ;
-	while(i < ((unsigned int) n - 1)){
-		--p[i];
-		int j = (i % 2 == 1) ? p[i] : 0;
-		swap(&solution, i+1, j+1);
+		vector<int> solution ;
+		solution.push_back(0) ;
+		solution.push_back(a) ;
+		solution.push_back(b) ;
+		for(int v = 1 ; v < n ; v++)
+			if(v != a && v != b && v != c)
+				solution.push_back(v) ;
+		solution.push_back(c) ;
 
+		//Quickperm on the positions 3 .. n-2
+		int r = n - 4 ;
+		vector<int> p (r);
+		for (int i = 0; i < r ; i++)
+			p[i] = i;
+
+		//the cost of the tour is kept up to date with the edges touched by each swap
 		int tmp = poids(graph, solution, type);
+		int i = 1 ;
+		while(true){
+			if (tmp < workerCost[w] && tmp < best.load()){
+				workerCost[w] = tmp;
+				workerSol[w] = solution ;
+				int curr = best.load() ;
+				while(tmp < curr && !best.compare_exchange_weak(curr, tmp)) ;
+			}
 
-		if (tmp < min){
-			min = tmp;
-			bestSol = solution ;
+			if(i >= r)
+				break ;
+			--p[i];
+			int j = (i % 2 == 1) ? p[i] : 0;
+			tmp -= touchedCost(graph, solution, j+3, i+3, type) ;
+			swap(&solution, i+3, j+3);
+			tmp += touchedCost(graph, solution, j+3, i+3, type) ;
+			i = 1;
+			while (i < r && p[i] == 0){
+				p[i] = i;
+				i++;
+			}
 		}
-		i = 1;
-		while (i < p.size() && p[i] == 0){
-			p[i] = i;
-			i++;
+	}, threads) ;
+
+	int min = poids(graph, bestSol, type) ;
+	for(int w = 0 ; w < threads ; w++) {
+		if(workerCost[w] < min) {
+			min = workerCost[w] ;
+			bestSol = workerSol[w] ;
 		}
 	}
 	return bestSol ;
@@ -82,174 +166,219 @@ vector<int> bruteForce(vector<vector<int> > graph, int type){
 
 //Backtracking implementation
 //algorithm from http://www.win.tue.nl/~kbuchin/teaching/2IL15/backtracking.pdf
-vector<int> backTracking(vector<vector<int> > graph, int type) {
-	vector<int> begin ;
-	for(int i = 0 ; i < graph.size() ; i++)
-		begin.push_back(i) ;
+vector<int> backTracking(const DistanceMatrix& graph, int type, const vector<int>& incumbent) {
+	vector<int> Sol = incumbent ;
+	if(Sol.empty())
+		Sol = warmStart(graph, type) ;
 
-	return backTracking_(graph, type, begin, 0, 0, begin);
+	backTracking_(graph, type, Sol);
+	return Sol ;
 }
 
-vector<int> backTracking_(vector<vector<int> > graph, int type, vector<int> A, int l, int lengthSoFar, vector<int> Sol) {
-	int n = A.size() ;
-	int minCost = poids(graph, Sol);
-	if(l == n) {
-		int newCost = lengthSoFar + graph[A[n-1]][A[0]] ;
-		if(newCost < minCost)
-			Sol = A ;
+//index of the first vertex >= v missing from the 'visited' bitset, n if there is none
+static inline int nextUnvisited(const vector<uint64_t>& visited, int v, int n) {
+	int w = v >> 6 ;
+	if(w >= (int) visited.size())
+		return n ;
+	uint64_t free = ~visited[w] & (~(uint64_t) 0 << (v & 63)) ;
+	while(free == 0) {
+		if(++w == (int) visited.size())
+			return n ;
+		free = ~visited[w] ;
 	}
-	else {
-		for(int i = l ; i < n ; i++) {
-			swap(&A, l, i) ;
-			int newLength = lengthSoFar + graph[A[l-1]][A[l]] ;
-			if(newLength <= minCost) {
-				vector<int> newSol = backTracking_(graph, type, A, l+1, newLength, Sol) ;
-				if(poids(graph, newSol) < minCost) {
-					Sol = newSol ;
-				}
+	int res = (w << 6) + __builtin_ctzll(free) ;
+	return res < n ? res : n ;
+}
+
+//Sol is the incumbent on entry and the best tour found on exit, its cost is returned
+//vertex 0 stays in position 0, the path being built is path[0 .. depth-1] and
+//next[d] is the next vertex to try in position d, so no memory is allocated
+//once the search has started
+int backTracking_(const DistanceMatrix& graph, int type, vector<int>& Sol) {
+	int n = Sol.size() ;
+	int minCost = poids(graph, Sol, type);
+	if(n <= 3)
+		return minCost ;
+
+	vector<int> path (n) ;
+	vector<int> next (n + 1) ;
+	vector<int> length (n + 1) ; //length[d] is the length of path[0 .. d-1]
+	vector<uint64_t> visited ((n + 63) / 64, 0) ;
+
+	path[0] = 0 ;
+	visited[0] |= 1 ;
+	int depth = 1 ;
+	next[1] = 1 ;
+	length[1] = 0 ;
+	while(depth > 0) {
+		if(depth == n) {
+			int newCost = length[n] + edgeCost(graph, path[n-1], path[0], type) ;
+			if(newCost < minCost) {
+				minCost = newCost ;
+				copy(path.begin(), path.end(), Sol.begin()) ;
 			}
-			swap(&A, l, i) ;
+			depth-- ;
+			visited[path[depth] >> 6] &= ~((uint64_t) 1 << (path[depth] & 63)) ;
+			continue ;
 		}
-	}
 
-	return Sol ;
-}
+		int last = path[depth-1] ;
+		int v = nextUnvisited(visited, next[depth], n) ;
+		while(v < n && length[depth] + edgeCost(graph, last, v, type) >= minCost)
+			v = nextUnvisited(visited, v + 1, n) ;
+		if(v == n) {
+			depth-- ;
+			if(depth > 0)
+				visited[path[depth] >> 6] &= ~((uint64_t) 1 << (path[depth] & 63)) ;
+			continue ;
+		}
+
+		next[depth] = v + 1 ;
+		path[depth] = v ;
+		visited[v >> 6] |= (uint64_t) 1 << (v & 63) ;
+		length[depth+1] = length[depth] + edgeCost(graph, last, v, type) ;
+		depth++ ;
+		next[depth] = 1 ;
+	}
 
-int edgeWeight(vector<int> edge, vector<vector<int> > graph) {
-	return graph[edge[0]][edge[1]] ;
+	return minCost ;
 }
 
-int partitionner(vector<vector<int> > *edges, int begin, int end, int pivot, vector<vector<int> > graph) {
-	vector<int> tmp = (*edges)[pivot] ;
-	(*edges)[pivot] = (*edges)[end] ;
-	(*edges)[end] = tmp ;
-	int j = begin ;
-	for(int i = begin ; i < end - 1 ; i++) {
-		if( edgeWeight((*edges)[i],graph) <= edgeWeight((*edges)[end],graph) ) {
-			tmp = (*edges)[i] ;
-			(*edges)[i] = (*edges)[j] ;
-			(*edges)[j++] = tmp ;
-		}
+//adjacency lists of the edges in compressed form: the neighbours of u are
+//neighbour[offset[u] .. offset[u+1]-1], and id[] gives the index of the edge
+void buildAdjacency(int n, const vector<pair<int, int> >& edges, vector<int>& offset, vector<int>& neighbour, vector<int>& id) {
+	offset.assign(n + 1, 0) ;
+	for(size_t e = 0 ; e < edges.size() ; e++) {
+		offset[edges[e].first + 1]++ ;
+		offset[edges[e].second + 1]++ ;
+	}
+	for(int u = 0 ; u < n ; u++)
+		offset[u + 1] += offset[u] ;
+	neighbour.resize(2 * edges.size()) ;
+	id.resize(2 * edges.size()) ;
+	vector<int> pos (offset.begin(), offset.end() - 1) ;
+	for(size_t e = 0 ; e < edges.size() ; e++) {
+		int u = edges[e].first, v = edges[e].second ;
+		id[pos[u]] = e ;
+		neighbour[pos[u]++] = v ;
+		id[pos[v]] = e ;
+		neighbour[pos[v]++] = u ;
 	}
-	tmp = (*edges)[end] ;
-	(*edges)[end] = (*edges)[j] ;
-	(*edges)[j] = tmp ;
-	return j ;
 }
 
-void quickSort(vector<vector<int> > *edges, int begin, int end, vector<vector<int> > graph) {
-	if(begin < end) {
-		int pivot = begin ;
-	    pivot = partitionner(edges, begin, end, pivot, graph) ;
-	    quickSort(edges ,begin, pivot-1, graph) ;
-	    quickSort(edges, pivot+1, end, graph) ;
+//double-tree approximation: the preorder of a depth first search of the
+//minimum spanning tree is the tree walk with the repeated vertices shortcut
+vector<int> minimumSpanningTree(const DistanceMatrix& graph, int engine) {
+	int n = graph.size() ;
+	vector<pair<int, int> > tree = spanningTree(graph, engine) ;
+	vector<int> offset, neighbour, id ;
+	buildAdjacency(n, tree, offset, neighbour, id) ;
+
+	vector<int> cycle ;
+	if(n == 0)
+		return cycle ;
+	vector<char> visited (n, 0) ;
+	vector<int> stack (1, 0) ;
+	while(!stack.empty()) {
+		int u = stack.back() ;
+		stack.pop_back() ;
+		if(visited[u])
+			continue ;
+		visited[u] = 1 ;
+		cycle.push_back(u) ;
+		for(int k = offset[u + 1] - 1 ; k >= offset[u] ; k--)
+			if(!visited[neighbour[k]])
+				stack.push_back(neighbour[k]) ;
 	}
+	return cycle ;
 }
 
-vector<int> minimumSpanningTree(vector<vector<int> > graph) {
-	vector<vector<int> > mst ;
-	vector<vector<int> > edges ;
-	vector<int> component ;
-
-	//we put the edges in 'edges'
-	for(int i = 0 ; i < graph.size() ; i++) {
-		for(int j = i + 1 ; j < graph.size() ; j++) {
-			vector<int> currEdge ;
-			currEdge.push_back(i) ;
-			currEdge.push_back(j) ;
-			edges.push_back(currEdge) ;
+//greedy minimum weight perfect matching of the vertices in 'odd': the pairs
+//made of every vertex and its nearest candidates are matched by increasing
+//weight, the vertices left are then matched with their nearest unmatched one
+vector<pair<int, int> > greedyMatching(const DistanceMatrix& graph, const vector<int>& odd) {
+	int k = odd.size() ;
+	int nbCandidates = k - 1 < MATCHING_CANDIDATES ? k - 1 : MATCHING_CANDIDATES ;
+	vector<int> from, to, weight ;
+	vector<pair<int, int> > row (k) ;
+	for(int a = 0 ; a < k ; a++) {
+		for(int b = 0 ; b < k ; b++)
+			row[b] = make_pair(b == a ? INT_MAX : graph(odd[a], odd[b]), b) ;
+		nth_element(row.begin(), row.begin() + nbCandidates, row.end()) ;
+		for(int c = 0 ; c < nbCandidates ; c++) {
+			from.push_back(a) ;
+			to.push_back(row[c].second) ;
+			weight.push_back(row[c].first) ;
 		}
 	}
+	vector<int> order ;
+	sortEdges(weight, order) ;
 
-	//we sort 'edges'
-	quickSort(&edges, 0, edges.size()-1, graph) ;
-
-	//we initialize the component
-	for(int i = 0 ; i < graph.size() ; i++)
-		component.push_back(i) ;
-
-	int count = 0 ;
-	int i = 0 ;
-	while(count < (graph.size() - 1) && i < edges.size()) {
-		int u = edges[i][0] ;
-		int v = edges[i][1] ;
-		if(component[u] != component[v]) {
-			mst.push_back(edges[i]) ;
-			int uComp = component[u] ;
-			for(int j = 0 ; j < component.size() ; j++)
-				if(component[j] == uComp)
-					component[j] = component[v] ;
-			count++ ;
+	vector<pair<int, int> > matching ;
+	vector<char> matched (k, 0) ;
+	for(size_t c = 0 ; c < order.size() ; c++) {
+		int a = from[order[c]], b = to[order[c]] ;
+		if(!matched[a] && !matched[b]) {
+			matched[a] = matched[b] = 1 ;
+			matching.push_back(make_pair(odd[a], odd[b])) ;
 		}
-		i++ ;
 	}
+	for(int a = 0 ; a < k ; a++) {
+		if(matched[a])
+			continue ;
+		int best = -1 ;
+		for(int b = a + 1 ; b < k ; b++)
+			if(!matched[b] && (best == -1 || graph(odd[a], odd[b]) < graph(odd[a], odd[best])))
+				best = b ;
+		matched[a] = matched[best] = 1 ;
+		matching.push_back(make_pair(odd[a], odd[best])) ;
+	}
+	return matching ;
+}
+
+//Christofides: the minimum spanning tree plus a matching of its odd degree
+//vertices is eulerian, its euler circuit is shortcut into a tour
+vector<int> christofides(const DistanceMatrix& graph, int engine) {
+	int n = graph.size() ;
+	vector<pair<int, int> > edges = spanningTree(graph, engine) ;
+	vector<int> degree (n, 0) ;
+	for(size_t e = 0 ; e < edges.size() ; e++) {
+		degree[edges[e].first]++ ;
+		degree[edges[e].second]++ ;
+	}
+	vector<int> odd ;
+	for(int u = 0 ; u < n ; u++)
+		if(degree[u] % 2 == 1)
+			odd.push_back(u) ;
+	vector<pair<int, int> > matching = greedyMatching(graph, odd) ;
+	edges.insert(edges.end(), matching.begin(), matching.end()) ;
 
-	//find a hamiltonian path from the minimum spanning tree
+	vector<int> offset, neighbour, id ;
+	buildAdjacency(n, edges, offset, neighbour, id) ;
+
+	//Hierholzer, the circuit comes out reversed and each vertex is kept the first time it appears
 	vector<int> cycle ;
-	cycle.push_back(edges[0][0]) ;
-	cycle.push_back(edges[0][1]) ;
-
-	i = 1 ;
-	int cpt = 0 ;
-	int cycleSize = mst.size() ;
-	while(cpt < cycleSize - 1) {
-		int u = mst[i][0] ;
-		int v = mst[i][1] ;
-		bool added = false ;
-		for(int j = 0 ; j < cycle.size() ; j++) {
-			if(u == cycle[j]) {
-				if(j+1 == cycle.size()) {
-					cycle.push_back(v) ;
-					cycle.push_back(u) ;
-				} else {
-					cycle.insert(cycle.begin() + j+1,v) ;
-					cycle.insert(cycle.begin() + j+2,u) ;
-				}
-				cpt++ ;
-				added = true ;
-				break ;
-			}
-			else if(v == cycle[j]) {
-				if(j+1 == cycle.size()) {
-					cycle.push_back(u) ;
-					cycle.push_back(v) ;
-				} else {
-					cycle.insert(cycle.begin() + j+1,u) ;
-					cycle.insert(cycle.begin() + j+2,v) ;
-				}
-				cpt++ ;
-				added = true ;
-				break ;
+	if(n == 0)
+		return cycle ;
+	vector<char> used (edges.size(), 0) ;
+	vector<char> visited (n, 0) ;
+	vector<int> next (offset.begin(), offset.end() - 1) ;
+	vector<int> stack (1, 0) ;
+	while(!stack.empty()) {
+		int u = stack.back() ;
+		while(next[u] < offset[u + 1] && used[id[next[u]]])
+			next[u]++ ;
+		if(next[u] == offset[u + 1]) {
+			stack.pop_back() ;
+			if(!visited[u]) {
+				visited[u] = 1 ;
+				cycle.push_back(u) ;
 			}
 		}
-		if(!added)
-			mst.push_back(edges[i]) ;
-		i++ ;
+		else {
+			used[id[next[u]]] = 1 ;
+			stack.push_back(neighbour[next[u]]) ;
+		}
 	}
 	return cycle ;
 }
-
-int SAT(vector<vector<int> > graph){
-	for(int i = 0 ; i < graph.size(); i++) {
-	  graphToSAT("tmpSAT", graph, i) ;
-	 
-	  FILE *fpipe;
-	  char *command = "./glucose-syrup_static tmpSAT -model | grep \"s SATISFIABLE\"";
-	  char path[1035];
-	  if(0 == (fpipe = (FILE*)popen(command,"r"))){
-	    printf("Failed to run glucose!\n");
-	    exit(1);
-	  }
-
-	
-	  while(fgets(path, sizeof(path)-1, fpipe) != NULL ){
-	    if(strcmp(path, "s SATISFIABLE") == 0){
-	      printf("Satisfiable !\n");
-	      return i;
-	    }
-	  }
-	  
-	}
-	return graph.size() ;
-}
-
@@ -0,0 +1,617 @@
+//Benchmark sweeps
+//Each trial runs in a child process: it can be killed when it exceeds the
+//timeout of its algorithm, and its CPU time (getrusage, every thread
+//included) is its own. The wall-clock time is taken with steady_clock
+//around the algorithm only, the instances are generated beforehand.
+//Independent trials run side by side on a pool of jobs, each in its own
+//temporary directory; the results are collected by trial index so the
+//report does not depend on which trial finished first.
+
+#include "../include/Benchmark.h"
+#include "../include/Utility.h"
+#include "../include/Reduction.h"
+#include "../include/Parallel.h"
+#include "../include/Results.h"
+#include "../include/Corpus.h"
+#include "../include/Generators.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <ftw.h>
+#include <poll.h>
+#include <sched.h>
+#include <signal.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define LOW_PERCENTILE  10
+#define HIGH_PERCENTILE 90
+
+struct AlgorithmEntry {
+	const char* name ;
+	Algorithms id ;
+	bool discreteOnly ;
+	const char* description ;
+} ;
+
+static const AlgorithmEntry ALGORITHMS[] = {
+	{ "brute", BRUTE, false, "brute" },
+	{ "bt", BT, false, "backTracking" },
+	{ "mst", MST, false, "minimumSpanningTree" },
+	{ "mst+2opt", MST2OPT, false, "mst+2opt" },
+	{ "lk", LK, false, "lin-kernighan" },
+	{ "pathcover", PATHCOVER, true, "path cover" },
+	{ "pathcover-exact", PATHCOVER_EXACT, true, "exact path cover" },
+	{ "christofides", CHRISTOFIDES, false, "christofides" },
+	{ "sat", sat, true, "sat" },
+	{ "dp", DP, false, "dp" },
+	{ "bnb", BNB, false, "branch and bound" }
+} ;
+
+static const AlgorithmEntry* findAlgorithm(const string& name) {
+	for(size_t i = 0 ; i < sizeof(ALGORITHMS) / sizeof(ALGORITHMS[0]) ; i++)
+		if(name == ALGORITHMS[i].name)
+			return &ALGORITHMS[i] ;
+	return NULL ;
+}
+
+bool knownAlgorithm(const string& name, int mode) {
+	const AlgorithmEntry* entry = findAlgorithm(name) ;
+	return entry != NULL && (mode == DISCRETE || !entry->discreteOnly) ;
+}
+
+uint64_t instanceSeed(const BenchmarkConfig& config, int n, int repetition) {
+	return deriveSeed(config.seed, n, repetition) ;
+}
+
+bool knownGenerator(const string& name, int mode) {
+	if(mode == DISCRETE)
+		return name == "gnp" || name == "gnm" || name == "geometric" ;
+	return name == "uniform" || name == "euclidean" ;
+}
+
+DistanceMatrix benchmarkInstance(const BenchmarkConfig& config, int n, int repetition) {
+	uint64_t seed = instanceSeed(config, n, repetition) ;
+	if(config.generator == "gnm")
+		return gnm(n, llround(config.density * n * (n - 1) / 2), seed) ;
+	if(config.generator == "geometric")
+		return randomGeometric(n, sqrt(config.density / M_PI), seed) ;
+	if(config.generator == "euclidean")
+		return euclidean(n, n * config.weightFactor, seed) ;
+	if(config.mode == DISCRETE)
+		return generateGraph(n, config.density, seed) ;
+	return generateRandomGraph(n, n * config.weightFactor, seed) ;
+}
+
+static vector<int> runEngine(Algorithms id, const DistanceMatrix& graph, int mode) {
+	vector<int> tour ;
+	switch(id) {
+	case BRUTE :
+		return bruteForce(graph, mode) ;
+	case BT :
+		return backTracking(graph, mode) ;
+	case MST :
+		return minimumSpanningTree(graph) ;
+	case MST2OPT :
+		tour = minimumSpanningTree(graph) ;
+		improveTour(graph, tour, mode) ;
+		return tour ;
+	case LK :
+		return linKernighan(graph, mode) ;
+	case PATHCOVER :
+		return pathCover(graph) ;
+	case PATHCOVER_EXACT :
+		return pathCover(graph, true) ;
+	case CHRISTOFIDES :
+		return christofides(graph) ;
+	case DP :
+		return heldKarp(graph, mode) ;
+	default :
+		return branchAndBound(graph, mode) ;
+	}
+}
+
+//tour of the graph: in DISCRETE mode brute, bt and mst run on the reduced
+//graph and their tour is expanded back to the graph
+static vector<int> solve(Algorithms id, const DistanceMatrix& graph, int mode) {
+	if(mode != DISCRETE || (id != BRUTE && id != BT && id != MST))
+		return runEngine(id, graph, mode) ;
+	GraphReduction reduced = reduceGraph(graph) ;
+	return expandTour(graph, reduced, runEngine(id, reduced.graph, mode)) ;
+}
+
+int runAlgorithm(const string& name, const DistanceMatrix& graph, int mode) {
+	Algorithms id = findAlgorithm(name)->id ;
+	//SAT only gives the cost, of the reduced graph plus the vertices taken out
+	if(id == sat) {
+		GraphReduction reduced = reduceGraph(graph) ;
+		SATOptions options ;
+		options.lowerBound = reduced.lowerBound - reduced.baseCost ;
+		return reduced.baseCost + SAT(reduced.graph, options) ;
+	}
+	//an engine refuses a graph above its size limit with an empty tour
+	vector<int> tour = solve(id, graph, mode) ;
+	if(tour.empty() && graph.size() > 0)
+		return -1 ;
+	return poids(graph, tour, mode) ;
+}
+
+static double cpuSeconds() {
+	struct rusage usage ;
+	getrusage(RUSAGE_SELF, &usage) ;
+	return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * 1e-6 ;
+}
+
+//cores each job may run on, the cores of the process split in contiguous
+//blocks, or shared round robin when there are more jobs than cores
+static vector<cpu_set_t> jobCores(int jobs) {
+	cpu_set_t allowed ;
+	vector<int> cores ;
+	if(sched_getaffinity(0, sizeof(allowed), &allowed) == 0)
+		for(int c = 0 ; c < CPU_SETSIZE ; c++)
+			if(CPU_ISSET(c, &allowed))
+				cores.push_back(c) ;
+	vector<cpu_set_t> res (jobs) ;
+	for(int j = 0 ; j < jobs ; j++) {
+		CPU_ZERO(&res[j]) ;
+		if(cores.empty())
+			continue ;
+		int first = j * cores.size() / jobs, last = (j + 1) * cores.size() / jobs ;
+		if(first == last)
+			CPU_SET(cores[j % cores.size()], &res[j]) ;
+		for(int c = first ; c < last ; c++)
+			CPU_SET(cores[c], &res[j]) ;
+	}
+	return res ;
+}
+
+static int removeEntry(const char* path, const struct stat*, int, struct FTW*) {
+	return remove(path) ;
+}
+
+//the trial as seen from the parent
+struct RunningTrial {
+	pid_t pid ;
+	int channel ;
+	size_t index ;
+	int job ;
+	string workspace ;
+	chrono::steady_clock::time_point deadline ;
+	bool limited ;
+} ;
+
+//child side: never returns
+static void runChild(const Trial& trial, int mode, const string& workspace, const cpu_set_t* cores, int channel) {
+	TrialResult res ;
+	res.status = TRIAL_FAILED ;
+	res.wall = res.cpu = 0 ;
+	res.cost = -1 ;
+	res.maxRss = 0 ;
+	if(cores != NULL)
+		sched_setaffinity(0, sizeof(*cores), cores) ;
+	//whatever the algorithm writes stays in the workspace
+	if(chdir(workspace.c_str()) == 0 && setenv("TMPDIR", workspace.c_str(), 1) == 0) {
+		//untimed runs first, they warm the caches and the allocator of this process
+		for(int w = 0 ; w < trial.warmup ; w++)
+			runAlgorithm(trial.algorithm, *trial.graph, mode) ;
+		double cpu = cpuSeconds() ;
+		chrono::steady_clock::time_point start = chrono::steady_clock::now() ;
+		res.cost = runAlgorithm(trial.algorithm, *trial.graph, mode) ;
+		res.wall = chrono::duration<double>(chrono::steady_clock::now() - start).count() ;
+		res.cpu = cpuSeconds() - cpu ;
+		res.status = res.cost < 0 ? TRIAL_FAILED : TRIAL_OK ;
+		struct rusage usage ;
+		getrusage(RUSAGE_SELF, &usage) ;
+		res.maxRss = usage.ru_maxrss ;
+	}
+	ssize_t written = write(channel, &res, sizeof(res)) ;
+	_exit(written == sizeof(res) ? 0 : 1) ;
+}
+
+vector<TrialResult> runTrials(const vector<Trial>& trials, int mode, int jobs, int pin) {
+	TrialResult failed ;
+	failed.status = TRIAL_FAILED ;
+	failed.wall = failed.cpu = 0 ;
+	failed.cost = -1 ;
+	failed.maxRss = 0 ;
+	vector<TrialResult> res (trials.size(), failed) ;
+	if(jobs <= 0)
+		jobs = hardwareThreads() ;
+	vector<cpu_set_t> cores = jobCores(jobs) ;
+	vector<char> busy (jobs, 0) ;
+	vector<RunningTrial> running ;
+	size_t next = 0 ;
+
+	while(next < trials.size() || !running.empty()) {
+		//starts trials on the free jobs, in order
+		while(next < trials.size() && (int) running.size() < jobs) {
+			RunningTrial run ;
+			run.index = next++ ;
+			run.job = find(busy.begin(), busy.end(), 0) - busy.begin() ;
+			string pattern = tempDirectory() + "/satan.XXXXXX" ;
+			vector<char> path (pattern.begin(), pattern.end()) ;
+			path.push_back('\0') ;
+			int channel[2] ;
+			if(mkdtemp(path.data()) == NULL)
+				continue ;
+			run.workspace = path.data() ;
+			if(pipe(channel) != 0) {
+				rmdir(run.workspace.c_str()) ;
+				continue ;
+			}
+			cout.flush() ;
+			run.pid = fork() ;
+			if(run.pid == 0) {
+				close(channel[0]) ;
+				runChild(trials[run.index], mode, run.workspace, pin == PIN_CORES ? &cores[run.job] : NULL, channel[1]) ;
+			}
+			close(channel[1]) ;
+			if(run.pid < 0) {
+				close(channel[0]) ;
+				rmdir(run.workspace.c_str()) ;
+				continue ;
+			}
+			run.channel = channel[0] ;
+			run.limited = trials[run.index].timeout > 0 ;
+			double limit = trials[run.index].timeout * (1 + trials[run.index].warmup) ;
+			run.deadline = chrono::steady_clock::now() + chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double>(limit)) ;
+			busy[run.job] = 1 ;
+			running.push_back(run) ;
+		}
+		if(running.empty())
+			continue ;
+
+		//waits for a result or for the closest deadline
+		vector<struct pollfd> ready (running.size()) ;
+		int wait = -1 ;
+		chrono::steady_clock::time_point now = chrono::steady_clock::now() ;
+		for(size_t i = 0 ; i < running.size() ; i++) {
+			ready[i].fd = running[i].channel ;
+			ready[i].events = POLLIN ;
+			ready[i].revents = 0 ;
+			if(running[i].limited) {
+				int left = max((int) chrono::duration_cast<chrono::milliseconds>(running[i].deadline - now).count() + 1, 0) ;
+				wait = wait < 0 ? left : min(wait, left) ;
+			}
+		}
+		poll(ready.data(), ready.size(), wait) ;
+
+		now = chrono::steady_clock::now() ;
+		for(size_t i = running.size() ; i-- > 0 ; ) {
+			RunningTrial& run = running[i] ;
+			TrialResult& trial = res[run.index] ;
+			if(ready[i].revents != 0) {
+				if(read(run.channel, &trial, sizeof(trial)) != sizeof(trial))
+					trial = failed ;
+			}
+			else if(run.limited && now >= run.deadline) {
+				kill(run.pid, SIGKILL) ;
+				trial.status = TRIAL_TIMEOUT ;
+			}
+			else
+				continue ;
+			close(run.channel) ;
+			waitpid(run.pid, NULL, 0) ;
+			nftw(run.workspace.c_str(), removeEntry, 16, FTW_DEPTH | FTW_PHYS) ;
+			busy[run.job] = 0 ;
+			running.erase(running.begin() + i) ;
+		}
+	}
+	return res ;
+}
+
+TrialResult runTrial(const string& name, const DistanceMatrix& graph, int mode, double timeout) {
+	Trial trial ;
+	trial.algorithm = name ;
+	trial.graph = &graph ;
+	trial.timeout = timeout ;
+	return runTrials(vector<Trial>(1, trial), mode)[0] ;
+}
+
+//percentile of sorted values, linear interpolation between the closest ranks
+static double percentile(const vector<double>& sorted, double p) {
+	double rank = p / 100 * (sorted.size() - 1) ;
+	size_t below = (size_t) rank ;
+	if(below + 1 >= sorted.size())
+		return sorted.back() ;
+	return sorted[below] + (rank - below) * (sorted[below + 1] - sorted[below]) ;
+}
+
+static double timeoutOf(const BenchmarkConfig& config, const string& name) {
+	map<string, double>::const_iterator it = config.timeouts.find(name) ;
+	return it == config.timeouts.end() ? config.timeout : it->second ;
+}
+
+//the timed trials of one size, in the order of the configuration
+static vector<ResultRecord> resultRecords(const BenchmarkConfig& config, int n, const vector<Trial>& trials, const vector<TrialResult>& results, const vector<size_t>& first, const vector<char>& dropped, const vector<uint64_t>& seeds) {
+	static const char* STATUS[] = { "ok", "timeout", "failed" } ;
+	vector<ResultRecord> res ;
+	for(size_t a = 0 ; a < first.size() ; a++) {
+		if(dropped[a])
+			continue ;
+		for(int r = 0 ; r < config.repetitions ; r++) {
+			const Trial& trial = trials[first[a] + r] ;
+			const TrialResult& result = results[first[a] + r] ;
+			ResultRecord record ;
+			record.build = SATAN_BUILD ;
+			record.mode = config.mode == DISCRETE ? "discrete" : "weighted" ;
+			record.algorithm = trial.algorithm ;
+			record.n = n ;
+			record.density = config.mode == DISCRETE ? config.density : 0 ;
+			record.weight = config.mode == DISCRETE ? 0 : config.weightFactor ;
+			record.seed = seeds[r] ;
+			record.generator = config.generator ;
+			record.repetition = r ;
+			record.status = STATUS[result.status] ;
+			record.wall = result.wall ;
+			record.cpu = result.cpu ;
+			record.maxRss = result.maxRss ;
+			record.cost = result.cost ;
+			res.push_back(record) ;
+		}
+	}
+	return res ;
+}
+
+bool runBenchmark(const BenchmarkConfig& base) {
+	//the manifest of the corpus replaces the generation parameters
+	BenchmarkConfig config = base ;
+	vector<CorpusEntry> corpus ;
+	if(!config.corpus.empty()) {
+		if(!readCorpus(config.corpus.c_str(), config, corpus))
+			return false ;
+		for(size_t i = 0 ; i < config.algorithms.size() ; i++) {
+			if(!knownAlgorithm(config.algorithms[i], config.mode)) {
+				cerr << config.corpus << ": unknown algorithm " << config.algorithms[i] << " for the mode of the corpus" << endl ;
+				return false ;
+			}
+		}
+		cout << "instances of " << config.corpus << endl ;
+	}
+	else
+		cout << "seed " << config.seed << endl ;
+	string modeName = config.mode == DISCRETE ? "discrete" : "weighted" ;
+	size_t nbAlgorithms = config.algorithms.size() ;
+	vector<char> dropped (nbAlgorithms, 0) ;
+	vector<string> lines (nbAlgorithms) ;
+
+	for(size_t s = 0 ; s < config.sizes.size() ; s++) {
+		int n = config.sizes[s] ;
+		vector<DistanceMatrix> instances ;
+		vector<uint64_t> seeds ;
+		for(int r = 0 ; r < config.repetitions ; r++) {
+			if(config.corpus.empty()) {
+				instances.push_back(benchmarkInstance(config, n, r)) ;
+				seeds.push_back(instanceSeed(config, n, r)) ;
+				continue ;
+			}
+			size_t e = 0 ;
+			while(e < corpus.size() && (corpus[e].n != n || corpus[e].repetition != r))
+				e++ ;
+			DistanceMatrix graph ;
+			if(e == corpus.size()) {
+				cerr << config.corpus << ": no instance of size " << n << " for repetition " << r << endl ;
+				return false ;
+			}
+			if(!loadInstance(config.corpus.c_str(), corpus[e], graph))
+				return false ;
+			instances.push_back(graph) ;
+			seeds.push_back(corpus[e].seed) ;
+		}
+
+		//timed trials of each algorithm, all run together, each one warmed up
+		//in its own process
+		vector<Trial> trials ;
+		vector<size_t> first (nbAlgorithms, 0) ;
+		for(size_t a = 0 ; a < nbAlgorithms ; a++) {
+			if(dropped[a] || instances.empty())
+				continue ;
+			Trial trial ;
+			trial.algorithm = config.algorithms[a] ;
+			trial.timeout = timeoutOf(config, trial.algorithm) ;
+			trial.warmup = config.warmup ;
+			first[a] = trials.size() ;
+			for(size_t r = 0 ; r < instances.size() ; r++) {
+				trial.graph = &instances[r] ;
+				trials.push_back(trial) ;
+			}
+		}
+		vector<TrialResult> results = runTrials(trials, config.mode, config.jobs, config.pin) ;
+		if(!config.results.empty())
+			appendResults(config.results.c_str(), resultRecords(config, n, trials, results, first, dropped, seeds)) ;
+
+		for(size_t a = 0 ; a < nbAlgorithms ; a++) {
+			const string& name = config.algorithms[a] ;
+			if(dropped[a] || instances.empty())
+				continue ;
+			vector<double> wall, cpu ;
+			int timeouts = 0, failures = 0 ;
+			for(size_t r = 0 ; r < instances.size() ; r++) {
+				const TrialResult& trial = results[first[a] + r] ;
+				if(trial.status == TRIAL_OK) {
+					wall.push_back(trial.wall) ;
+					cpu.push_back(trial.cpu) ;
+				}
+				else if(trial.status == TRIAL_TIMEOUT)
+					timeouts++ ;
+				else
+					failures++ ;
+			}
+			if(timeouts > 0) {
+				dropped[a] = 1 ;
+				cout << modeName << " " << name << " n=" << n << ": " << timeouts << " trial(s) over " << timeoutOf(config, name) << "s, not run on larger graphs" << endl ;
+			}
+			if(failures > 0)
+				cout << modeName << " " << name << " n=" << n << ": " << failures << " trial(s) failed" << endl ;
+			if(wall.empty())
+				continue ;
+
+			sort(wall.begin(), wall.end()) ;
+			sort(cpu.begin(), cpu.end()) ;
+			double mean = 0, variance = 0 ;
+			for(size_t i = 0 ; i < wall.size() ; i++)
+				mean += wall[i] ;
+			mean /= wall.size() ;
+			for(size_t i = 0 ; i < wall.size() ; i++)
+				variance += (wall[i] - mean) * (wall[i] - mean) ;
+			double stddev = wall.size() > 1 ? sqrt(variance / (wall.size() - 1)) : 0 ;
+
+			ostringstream line ;
+			line << n << " " << percentile(wall, 50) << " " << percentile(wall, LOW_PERCENTILE) << " " << percentile(wall, HIGH_PERCENTILE)
+				<< " " << mean << " " << stddev << " " << percentile(cpu, 50) << " " << wall.size() << "\n" ;
+			lines[a] += line.str() ;
+			cout << modeName << " " << name << " " << line.str() ;
+
+			//the file is rewritten after every size, a sweep stopped early keeps its results
+			ofstream os ((modeName + "_" + name).c_str()) ;
+			os << "#" << findAlgorithm(name)->description << " for " << modeName << "\n" ;
+			os << "# |V(G)| median p" << LOW_PERCENTILE << " p" << HIGH_PERCENTILE << " mean stddev cpu_median trials\n" ;
+			os << lines[a] ;
+		}
+	}
+	return true ;
+}
+
+BenchmarkConfig defaultBenchmark(int mode, const string& algorithm) {
+	BenchmarkConfig config ;
+	config.mode = mode ;
+	config.generator = mode == DISCRETE ? "gnp" : "uniform" ;
+	config.algorithms.push_back(algorithm) ;
+	int first = 10, last = 100, step = 10 ;
+	if(algorithm == "dp") {
+		first = step = 5 ;
+		last = 25 ;
+	}
+	else if(algorithm == "pathcover-exact") {
+		first = step = 5 ;
+		last = 20 ;
+	}
+	for(int n = first ; n <= last ; n += step)
+		config.sizes.push_back(n) ;
+	return config ;
+}
+
+static string trim(const string& text) {
+	size_t begin = text.find_first_not_of(" \t\r") ;
+	if(begin == string::npos)
+		return "" ;
+	size_t end = text.find_last_not_of(" \t\r") ;
+	return text.substr(begin, end - begin + 1) ;
+}
+
+//items separated by commas or blanks
+static vector<string> splitList(const string& text) {
+	vector<string> res ;
+	string item ;
+	istringstream is (text) ;
+	while(is >> item) {
+		stringstream parts (item) ;
+		string part ;
+		while(getline(parts, part, ','))
+			if(!part.empty())
+				res.push_back(part) ;
+	}
+	return res ;
+}
+
+bool readBenchmarkConfig(const char* fileName, BenchmarkConfig& config) {
+	ifstream is (fileName) ;
+	if(!is) {
+		cerr << fileName << ": cannot be read" << endl ;
+		return false ;
+	}
+	config.algorithms.clear() ;
+	config.sizes.clear() ;
+	string line ;
+	int number = 0 ;
+	while(getline(is, line)) {
+		number++ ;
+		line = trim(line.substr(0, line.find('#'))) ;
+		if(line.empty())
+			continue ;
+		size_t equal = line.find('=') ;
+		string key = equal == string::npos ? line : trim(line.substr(0, equal)) ;
+		string value = equal == string::npos ? "" : trim(line.substr(equal + 1)) ;
+		bool ok = !value.empty() ;
+		if(!ok) ;
+		else if(key == "mode") {
+			ok = value == "discrete" || value == "weighted" ;
+			config.mode = value == "discrete" ? DISCRETE : WEIGHTED ;
+			if(config.mode == WEIGHTED && config.generator == "gnp")
+				config.generator = "uniform" ;
+		}
+		else if(key == "algorithms")
+			config.algorithms = splitList(value) ;
+		else if(key == "sizes") {
+			int first, last, step ;
+			char c1, c2 ;
+			istringstream range (value) ;
+			if(value.find(':') != string::npos) {
+				ok = (range >> first >> c1 >> last >> c2 >> step) && c1 == ':' && c2 == ':' && step > 0 ;
+				for(int n = first ; ok && n <= last ; n += step)
+					config.sizes.push_back(n) ;
+			}
+			else {
+				vector<string> sizes = splitList(value) ;
+				for(size_t i = 0 ; i < sizes.size() ; i++)
+					config.sizes.push_back(atoi(sizes[i].c_str())) ;
+			}
+		}
+		else if(key == "generator")
+			config.generator = value ;
+		else if(key == "density")
+			config.density = atof(value.c_str()) ;
+		else if(key == "weight")
+			config.weightFactor = atoi(value.c_str()) ;
+		else if(key == "repetitions")
+			config.repetitions = atoi(value.c_str()) ;
+		else if(key == "warmup")
+			config.warmup = atoi(value.c_str()) ;
+		else if(key == "timeout")
+			config.timeout = atof(value.c_str()) ;
+		else if(key == "seed")
+			config.seed = strtoull(value.c_str(), NULL, 10) ;
+		else if(key == "corpus")
+			config.corpus = value ;
+		else if(key == "results")
+			config.results = value ;
+		else if(key == "jobs")
+			config.jobs = atoi(value.c_str()) ;
+		else if(key == "pin") {
+			ok = value == "none" || value == "cores" ;
+			config.pin = value == "cores" ? PIN_CORES : PIN_NONE ;
+		}
+		else if(key.compare(0, 8, "timeout.") == 0)
+			config.timeouts[key.substr(8)] = atof(value.c_str()) ;
+		else
+			ok = false ;
+		if(!ok) {
+			cerr << fileName << ":" << number << ": invalid line \"" << line << "\"" << endl ;
+			return false ;
+		}
+	}
+
+	if(!knownGenerator(config.generator, config.mode)) {
+		cerr << fileName << ": unknown generator " << config.generator << " for this mode" << endl ;
+		return false ;
+	}
+	for(size_t i = 0 ; i < config.algorithms.size() ; i++) {
+		if(!knownAlgorithm(config.algorithms[i], config.mode)) {
+			cerr << fileName << ": unknown algorithm " << config.algorithms[i] << " for this mode" << endl ;
+			return false ;
+		}
+	}
+	for(size_t i = 0 ; i < config.sizes.size() ; i++) {
+		if(config.sizes[i] < 1) {
+			cerr << fileName << ": invalid size " << config.sizes[i] << endl ;
+			return false ;
+		}
+	}
+	return true ;
+}
@@ -0,0 +1,466 @@
+//Branch and bound with Held-Karp (Lagrangian 1-tree) lower bounds
+//algorithm from Held, Karp, "The traveling-salesman problem and minimum spanning trees: part II"
+//
+//The multipliers pi are computed once at the root by subgradient optimization.
+//Edges whose reduced cost proves that they cannot belong to a tour better than
+//the incumbent are removed, then the tours are built from vertex 0 by a depth
+//first search. Each subproblem (a path starting at 0) is bounded by the
+//minimum spanning tree, under the costs c(u,v) + pi[u] + pi[v], of its last
+//vertex, vertex 0 and the vertices not visited yet. Subproblems are shared
+//between the threads through one work-stealing deque per thread.
+
+#include "../include/Algorithmic.h"
+#include "../include/Parallel.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <thread>
+
+#define EPSILON 1e-7
+#define LOCAL_SEARCH_SIZE 12 //subproblems with less unvisited vertices are not shared
+#define BOUND_ITERATIONS 5   //subgradient steps at each subproblem
+
+struct OneTree {
+	double value ;      //weight of the 1-tree under the modified costs minus 2 * sum(pi)
+	vector<int> degree ;
+	vector<int> parent ;//parent in the spanning tree of 1 .. n-1, rooted at 1
+	int first, second ; //the two neighbours of 0
+} ;
+
+struct BnBNode {
+	vector<int> path ;
+	vector<double> pi ;
+	int cost ;
+} ;
+
+//deque owned by one thread: the owner works on the back, the thieves take the front
+struct WorkDeque {
+	mutex lock ;
+	deque<BnBNode> nodes ;
+} ;
+
+struct BnBContext {
+	int n ;
+	vector<int> cost ;
+	vector<double> pi ;
+	vector<char> allowed ;
+
+	atomic<int> best ;
+	mutex bestLock ;
+	vector<int> bestTour ;
+
+	vector<WorkDeque> deques ;
+	atomic<long> pending ;
+
+	BnBContext(int n, int threads) : n(n), best(0), deques(threads), pending(0) {}
+
+	inline double reduced(int u, int v) const { return cost[u * n + v] + pi[u] + pi[v] ; }
+} ;
+
+void computeOneTree(const vector<int>& cost, int n, const vector<double>& pi, OneTree& tree) {
+	tree.degree.assign(n, 0) ;
+	tree.parent.assign(n, -1) ;
+	vector<double> key (n, numeric_limits<double>::infinity()) ;
+	vector<char> inTree (n, 0) ;
+	double total = 0 ;
+
+	//Prim on the vertices 1 .. n-1
+	key[1] = 0 ;
+	for(int k = 1 ; k < n ; k++) {
+		int u = -1 ;
+		for(int v = 1 ; v < n ; v++)
+			if(!inTree[v] && (u == -1 || key[v] < key[u]))
+				u = v ;
+		inTree[u] = 1 ;
+		total += key[u] ;
+		if(tree.parent[u] != -1) {
+			tree.degree[u]++ ;
+			tree.degree[tree.parent[u]]++ ;
+		}
+		for(int v = 1 ; v < n ; v++) {
+			double w = cost[u * n + v] + pi[u] + pi[v] ;
+			if(!inTree[v] && w < key[v]) {
+				key[v] = w ;
+				tree.parent[v] = u ;
+			}
+		}
+	}
+
+	//and the two cheapest edges of 0
+	tree.first = tree.second = -1 ;
+	for(int v = 1 ; v < n ; v++) {
+		double w = cost[v] + pi[0] + pi[v] ;
+		if(tree.first == -1 || w < cost[tree.first] + pi[0] + pi[tree.first]) {
+			tree.second = tree.first ;
+			tree.first = v ;
+		}
+		else if(tree.second == -1 || w < cost[tree.second] + pi[0] + pi[tree.second])
+			tree.second = v ;
+	}
+	total += cost[tree.first] + pi[0] + pi[tree.first] ;
+	total += cost[tree.second] + pi[0] + pi[tree.second] ;
+	tree.degree[0] = 2 ;
+	tree.degree[tree.first]++ ;
+	tree.degree[tree.second]++ ;
+
+	double sum = 0 ;
+	for(int v = 0 ; v < n ; v++)
+		sum += pi[v] ;
+	tree.value = total - 2 * sum ;
+}
+
+//subgradient optimization of the multipliers, returns the best 1-tree bound
+double optimizeMultipliers(BnBContext& ctx) {
+	int n = ctx.n ;
+	vector<double> pi (n, 0) ;
+	ctx.pi = pi ;
+	double bestValue = -numeric_limits<double>::infinity() ;
+	double lambda = 2 ;
+	int noImprovement = 0 ;
+	OneTree tree ;
+
+	for(int iter = 0 ; iter < 100 + 10 * n && lambda > 1e-4 ; iter++) {
+		computeOneTree(ctx.cost, n, pi, tree) ;
+		if(tree.value > bestValue + EPSILON) {
+			bestValue = tree.value ;
+			ctx.pi = pi ;
+			noImprovement = 0 ;
+		}
+		else if(++noImprovement >= 10) {
+			lambda /= 2 ;
+			noImprovement = 0 ;
+		}
+
+		//the incumbent is optimal, or the 1-tree is a tour
+		if(bestValue > ctx.best - 1 + EPSILON)
+			break ;
+		double norm = 0 ;
+		for(int v = 0 ; v < n ; v++)
+			norm += (tree.degree[v] - 2) * (tree.degree[v] - 2) ;
+		if(norm == 0)
+			break ;
+
+		double step = lambda * (ctx.best - tree.value) / norm ;
+		for(int v = 0 ; v < n ; v++)
+			pi[v] += step * (tree.degree[v] - 2) ;
+	}
+	return bestValue ;
+}
+
+//reduced cost edge elimination: an edge is removed when the best 1-tree
+//forced to contain it is already as long as the incumbent
+void eliminateEdges(BnBContext& ctx, double bound) {
+	int n = ctx.n ;
+	OneTree tree ;
+	computeOneTree(ctx.cost, n, ctx.pi, tree) ;
+	ctx.allowed.assign(n * n, 1) ;
+
+	vector<vector<int> > adj (n) ;
+	for(int v = 1 ; v < n ; v++)
+		if(tree.parent[v] != -1) {
+			adj[v].push_back(tree.parent[v]) ;
+			adj[tree.parent[v]].push_back(v) ;
+		}
+
+	//heaviest edge on the tree path between i and every other vertex
+	vector<double> heaviest (n) ;
+	vector<int> stack ;
+	for(int i = 1 ; i < n ; i++) {
+		fill(heaviest.begin(), heaviest.end(), -numeric_limits<double>::infinity()) ;
+		vector<char> seen (n, 0) ;
+		seen[i] = 1 ;
+		stack.assign(1, i) ;
+		while(!stack.empty()) {
+			int u = stack.back() ;
+			stack.pop_back() ;
+			for(size_t k = 0 ; k < adj[u].size() ; k++) {
+				int v = adj[u][k] ;
+				if(!seen[v]) {
+					seen[v] = 1 ;
+					heaviest[v] = max(heaviest[u], ctx.reduced(u, v)) ;
+					stack.push_back(v) ;
+				}
+			}
+		}
+		for(int j = i + 1 ; j < n ; j++) {
+			if(tree.parent[i] == j || tree.parent[j] == i)
+				continue ;
+			if(bound + ctx.reduced(i, j) - heaviest[j] > ctx.best - 1 + EPSILON)
+				ctx.allowed[i * n + j] = ctx.allowed[j * n + i] = 0 ;
+		}
+	}
+
+	double second = ctx.reduced(0, tree.second) ;
+	for(int v = 1 ; v < n ; v++) {
+		if(v == tree.first || v == tree.second)
+			continue ;
+		if(bound + ctx.reduced(0, v) - second > ctx.best - 1 + EPSILON)
+			ctx.allowed[v] = ctx.allowed[v * n] = 0 ;
+	}
+}
+
+void updateIncumbent(BnBContext& ctx, const vector<int>& tour, int cost) {
+	lock_guard<mutex> guard (ctx.bestLock) ;
+	if(cost < ctx.best) {
+		ctx.bestTour = tour ;
+		ctx.best = cost ;
+	}
+}
+
+struct BoundWork {
+	vector<int> nodes ;
+	vector<double> key ;
+	vector<int> parent ;
+	vector<int> degree ;
+	vector<double> bestPi ;
+} ;
+
+//lower bound of the tours extending path[0 .. depth-1] (path[0] = 0)
+//The rest of the tour is a hamiltonian path from the last vertex to 0 through
+//the unvisited vertices W, and for every pi its length is at least
+//MST(W, c(u,v) + pi[u] + pi[v]) - sum(target[v] * pi[v]), target being 1 for
+//both ends and 2 for the others. pi starts from the multipliers of the parent
+//subproblem and is improved by a few subgradient steps, the best one is kept.
+//When the spanning tree is itself a path, the tour is a new incumbent.
+double lowerBound(BnBContext& ctx, const vector<int>& path, int depth, const vector<char>& visited, int cost, vector<double>& pi, BoundWork& work) {
+	int n = ctx.n ;
+	int last = path[depth - 1] ;
+	if(depth == n)
+		return ctx.allowed[last * n] ? cost + ctx.cost[last * n] : numeric_limits<double>::infinity() ;
+
+	vector<int>& nodes = work.nodes ;
+	nodes.clear() ;
+	nodes.push_back(last) ;
+	nodes.push_back(0) ;
+	for(int v = 1 ; v < n ; v++)
+		if(!visited[v])
+			nodes.push_back(v) ;
+	int k = nodes.size() ;
+	work.key.resize(k) ;
+	work.parent.resize(k) ;
+	work.degree.resize(k) ;
+
+	double best = -numeric_limits<double>::infinity() ;
+	for(int iter = 0 ; iter < BOUND_ITERATIONS ; iter++) {
+		//Prim, nodes already in the tree are moved to the front of 'nodes'
+		for(int i = 0 ; i < k ; i++) {
+			work.key[i] = numeric_limits<double>::infinity() ;
+			work.parent[i] = -1 ;
+			work.degree[i] = 0 ;
+		}
+		work.key[0] = 0 ;
+		double total = 0 ;
+		for(int step = 0 ; step < k ; step++) {
+			int u = step ;
+			for(int i = step + 1 ; i < k ; i++)
+				if(work.key[i] < work.key[u])
+					u = i ;
+			if(work.key[u] == numeric_limits<double>::infinity())
+				return work.key[u] ;
+			total += work.key[u] ;
+			swap(nodes[u], nodes[step]) ;
+			swap(work.key[u], work.key[step]) ;
+			swap(work.parent[u], work.parent[step]) ;
+			if(work.parent[step] != -1) {
+				work.degree[step]++ ;
+				work.degree[work.parent[step]]++ ;
+			}
+			int a = nodes[step] ;
+			for(int i = step + 1 ; i < k ; i++) {
+				int b = nodes[i] ;
+				if(ctx.allowed[a * n + b]) {
+					double w = ctx.cost[a * n + b] + pi[a] + pi[b] ;
+					if(w < work.key[i]) {
+						work.key[i] = w ;
+						work.parent[i] = step ;
+					}
+				}
+			}
+		}
+
+		double value = cost + total ;
+		double norm = 0 ;
+		for(int i = 0 ; i < k ; i++) {
+			int target = (nodes[i] == last || nodes[i] == 0) ? 1 : 2 ;
+			value -= target * pi[nodes[i]] ;
+			norm += (work.degree[i] - target) * (work.degree[i] - target) ;
+		}
+		if(value > best) {
+			best = value ;
+			work.bestPi = pi ;
+		}
+
+		if(norm == 0) {
+			//the tree is a path from last to 0
+			vector<int> tour (path.begin(), path.begin() + depth) ;
+			vector<vector<int> > adj (n) ;
+			for(int i = 1 ; i < k ; i++) {
+				adj[nodes[i]].push_back(nodes[work.parent[i]]) ;
+				adj[nodes[work.parent[i]]].push_back(nodes[i]) ;
+			}
+			int prev = last, curr = adj[last][0] ;
+			while(curr != 0) {
+				tour.push_back(curr) ;
+				int next = adj[curr][0] == prev ? adj[curr][1] : adj[curr][0] ;
+				prev = curr ;
+				curr = next ;
+			}
+			updateIncumbent(ctx, tour, (int) lround(value)) ;
+			break ;
+		}
+		if(ceil(best - EPSILON) >= ctx.best)
+			break ;
+
+		double step = (ctx.best - value) / norm ;
+		for(int i = 0 ; i < k ; i++) {
+			int target = (nodes[i] == last || nodes[i] == 0) ? 1 : 2 ;
+			pi[nodes[i]] += step * (work.degree[i] - target) ;
+		}
+	}
+	pi = work.bestPi ;
+	return best ;
+}
+
+//unvisited successors of last, cheapest reduced cost first
+void candidates(const BnBContext& ctx, int last, const vector<char>& visited, int cost, vector<int>& res) {
+	int n = ctx.n ;
+	res.clear() ;
+	for(int v = 1 ; v < n ; v++)
+		if(!visited[v] && ctx.allowed[last * n + v] && cost + ctx.cost[last * n + v] < ctx.best)
+			res.push_back(v) ;
+	sort(res.begin(), res.end(), [&](int a, int b) { return ctx.reduced(last, a) < ctx.reduced(last, b) ; }) ;
+}
+
+//sequential search of a small subproblem
+struct LocalSearch {
+	BnBContext& ctx ;
+	vector<int> path ;
+	vector<char> visited ;
+	BoundWork work ;
+	vector<vector<int> > next ;
+	vector<vector<double> > pi ; //multipliers of every depth
+
+	LocalSearch(BnBContext& ctx) : ctx(ctx), path(ctx.n), visited(ctx.n), next(ctx.n), pi(ctx.n + 1) {}
+
+	void run(int depth, int cost) {
+		double bound = lowerBound(ctx, path, depth, visited, cost, pi[depth], work) ;
+		if(ceil(bound - EPSILON) >= ctx.best)
+			return ;
+		int last = path[depth - 1] ;
+		if(depth == ctx.n) {
+			updateIncumbent(ctx, path, cost + ctx.cost[last * ctx.n]) ;
+			return ;
+		}
+		candidates(ctx, last, visited, cost, next[depth]) ;
+		for(size_t i = 0 ; i < next[depth].size() ; i++) {
+			int v = next[depth][i] ;
+			path[depth] = v ;
+			visited[v] = 1 ;
+			pi[depth + 1] = pi[depth] ;
+			run(depth + 1, cost + ctx.cost[last * ctx.n + v]) ;
+			visited[v] = 0 ;
+		}
+	}
+} ;
+
+bool takeWork(BnBContext& ctx, int self, BnBNode& node) {
+	{
+		WorkDeque& own = ctx.deques[self] ;
+		lock_guard<mutex> guard (own.lock) ;
+		if(!own.nodes.empty()) {
+			node = own.nodes.back() ;
+			own.nodes.pop_back() ;
+			return true ;
+		}
+	}
+	int threads = ctx.deques.size() ;
+	for(int k = 1 ; k < threads ; k++) {
+		WorkDeque& victim = ctx.deques[(self + k) % threads] ;
+		lock_guard<mutex> guard (victim.lock) ;
+		if(!victim.nodes.empty()) {
+			node = victim.nodes.front() ;
+			victim.nodes.pop_front() ;
+			return true ;
+		}
+	}
+	return false ;
+}
+
+void worker(BnBContext& ctx, int self) {
+	int n = ctx.n ;
+	LocalSearch local (ctx) ;
+	vector<int> children ;
+	BnBNode node ;
+
+	while(ctx.pending > 0) {
+		if(!takeWork(ctx, self, node)) {
+			this_thread::yield() ;
+			continue ;
+		}
+		int depth = node.path.size() ;
+		fill(local.visited.begin(), local.visited.end(), 0) ;
+		for(int i = 0 ; i < depth ; i++) {
+			local.path[i] = node.path[i] ;
+			local.visited[node.path[i]] = 1 ;
+		}
+
+		if(n - depth <= LOCAL_SEARCH_SIZE) {
+			local.pi[depth] = node.pi ;
+			local.run(depth, node.cost) ;
+		}
+		else if(ceil(lowerBound(ctx, local.path, depth, local.visited, node.cost, node.pi, local.work) - EPSILON) < ctx.best) {
+			//children are pushed so that the most promising one is popped first
+			int last = node.path.back() ;
+			candidates(ctx, last, local.visited, node.cost, children) ;
+			WorkDeque& own = ctx.deques[self] ;
+			lock_guard<mutex> guard (own.lock) ;
+			ctx.pending += children.size() ;
+			for(int i = children.size() - 1 ; i >= 0 ; i--) {
+				BnBNode child ;
+				child.path = node.path ;
+				child.path.push_back(children[i]) ;
+				child.pi = node.pi ;
+				child.cost = node.cost + ctx.cost[last * n + children[i]] ;
+				own.nodes.push_back(child) ;
+			}
+		}
+		ctx.pending-- ;
+	}
+}
+
+vector<int> branchAndBound(const DistanceMatrix& graph, int type, const vector<int>& incumbent) {
+	int n = graph.size() ;
+	vector<int> tour (n) ;
+	for(int i = 0 ; i < n ; i++)
+		tour[i] = i ;
+	if(n <= 3)
+		return tour ;
+
+	int threads = hardwareThreads() ;
+	BnBContext ctx (n, threads) ;
+	ctx.cost.resize(n * n) ;
+	for(int u = 0 ; u < n ; u++)
+		for(int v = 0 ; v < n ; v++)
+			ctx.cost[u * n + v] = edgeCost(graph, u, v, type) ;
+
+	ctx.bestTour = incumbent.empty() ? warmStart(graph, type) : incumbent ;
+	ctx.best = poids(graph, ctx.bestTour, type) ;
+
+	double bound = optimizeMultipliers(ctx) ;
+	if(bound > ctx.best - 1 + EPSILON)
+		return ctx.bestTour ;
+	eliminateEdges(ctx, bound) ;
+
+	BnBNode root ;
+	root.path.push_back(0) ;
+	root.pi = ctx.pi ;
+	root.cost = 0 ;
+	ctx.deques[0].nodes.push_back(root) ;
+	ctx.pending = 1 ;
+	parallelFor(threads, [&](int self, int) { worker(ctx, self) ; }, threads) ;
+
+	return ctx.bestTour ;
+}
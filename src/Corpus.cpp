@@ -0,0 +1,152 @@
+//Instance corpus
+//The instance of size n for repetition r has its own seed, derived from the
+//base seed, so the instances are generated independently of each other, in
+//parallel here. Each one is written in the matrix format of
+//readGraphFromMatrix, to a file named after the hash of its content: the
+//manifest records the hash, which is checked again when the instance is
+//loaded.
+
+#include "../include/Corpus.h"
+#include "../include/Parallel.h"
+#include "../include/Utility.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <sys/stat.h>
+
+uint64_t graphHash(const DistanceMatrix& graph) {
+	uint64_t hash = 0xCBF29CE484222325ULL ;
+	int n = graph.size() ;
+	auto mix = [&](uint32_t value) {
+		for(int b = 0 ; b < 4 ; b++) {
+			hash ^= (value >> (8 * b)) & 0xFF ;
+			hash *= 0x100000001B3ULL ;
+		}
+	} ;
+	mix(n) ;
+	for(int i = 0 ; i < n ; i++)
+		for(int j = 0 ; j < n ; j++)
+			mix(graph(i, j)) ;
+	return hash ;
+}
+
+static string hexHash(uint64_t hash) {
+	char text[17] ;
+	snprintf(text, sizeof(text), "%016llx", (unsigned long long) hash) ;
+	return text ;
+}
+
+bool writeCorpus(const BenchmarkConfig& config, const char* directory) {
+	if(mkdir(directory, 0755) != 0 && errno != EEXIST) {
+		cerr << directory << ": cannot be created" << endl ;
+		return false ;
+	}
+	vector<CorpusEntry> entries ;
+	for(size_t s = 0 ; s < config.sizes.size() ; s++) {
+		for(int r = 0 ; r < config.repetitions ; r++) {
+			CorpusEntry entry ;
+			entry.n = config.sizes[s] ;
+			entry.repetition = r ;
+			entry.seed = instanceSeed(config, entry.n, r) ;
+			entries.push_back(entry) ;
+		}
+	}
+
+	string dir (directory) ;
+	vector<DistanceMatrix> graphs (entries.size()) ;
+	parallelFor(entries.size(), [&](int i, int) {
+		CorpusEntry& entry = entries[i] ;
+		graphs[i] = benchmarkInstance(config, entry.n, entry.repetition) ;
+		entry.hash = graphHash(graphs[i]) ;
+		entry.file = hexHash(entry.hash) + ".txt" ;
+	}) ;
+
+	//equal instances share their file, which is written once
+	vector<size_t> unique ;
+	set<uint64_t> seen ;
+	for(size_t i = 0 ; i < entries.size() ; i++)
+		if(seen.insert(entries[i].hash).second)
+			unique.push_back(i) ;
+	vector<char> written (unique.size(), 0) ;
+	parallelFor(unique.size(), [&](int u, int) {
+		const CorpusEntry& entry = entries[unique[u]] ;
+		written[u] = writeGraph((dir + "/" + entry.file).c_str(), graphs[unique[u]]) ;
+	}) ;
+	if(find(written.begin(), written.end(), 0) != written.end())
+		return false ;
+
+	ofstream os ((dir + "/" + CORPUS_MANIFEST).c_str()) ;
+	os << "# SATan instance corpus\n" ;
+	os << "mode " << (config.mode == DISCRETE ? "discrete" : "weighted") << "\n" ;
+	os << "generator " << config.generator << "\n" ;
+	os << "density " << config.density << "\n" ;
+	os << "weight " << config.weightFactor << "\n" ;
+	os << "seed " << config.seed << "\n" ;
+	os << "# n repetition seed hash file\n" ;
+	for(size_t i = 0 ; i < entries.size() ; i++)
+		os << entries[i].n << " " << entries[i].repetition << " " << entries[i].seed << " " << hexHash(entries[i].hash) << " " << entries[i].file << "\n" ;
+	os.flush() ;
+	if(!os) {
+		cerr << dir << "/" << CORPUS_MANIFEST << ": cannot be written" << endl ;
+		return false ;
+	}
+	return true ;
+}
+
+bool readCorpus(const char* directory, BenchmarkConfig& config, vector<CorpusEntry>& entries) {
+	string fileName = string(directory) + "/" + CORPUS_MANIFEST ;
+	ifstream is (fileName.c_str()) ;
+	if(!is) {
+		cerr << fileName << ": cannot be read" << endl ;
+		return false ;
+	}
+	string line ;
+	while(getline(is, line)) {
+		if(line.empty() || line[0] == '#')
+			continue ;
+		istringstream fields (line) ;
+		string key, hash ;
+		if(line.compare(0, 5, "mode ") == 0) {
+			fields >> key >> key ;
+			config.mode = key == "discrete" ? DISCRETE : WEIGHTED ;
+			config.generator = config.mode == DISCRETE ? "gnp" : "uniform" ;
+		}
+		else if(line.compare(0, 10, "generator ") == 0)
+			fields >> key >> config.generator ;
+		else if(line.compare(0, 8, "density ") == 0)
+			fields >> key >> config.density ;
+		else if(line.compare(0, 7, "weight ") == 0)
+			fields >> key >> config.weightFactor ;
+		else if(line.compare(0, 5, "seed ") == 0)
+			fields >> key >> config.seed ;
+		else {
+			CorpusEntry entry ;
+			if(!(fields >> entry.n >> entry.repetition >> entry.seed >> hash >> entry.file)) {
+				cerr << fileName << ": invalid line \"" << line << "\"" << endl ;
+				return false ;
+			}
+			entry.hash = strtoull(hash.c_str(), NULL, 16) ;
+			entries.push_back(entry) ;
+		}
+	}
+	return true ;
+}
+
+bool loadInstance(const char* directory, const CorpusEntry& entry, DistanceMatrix& graph) {
+	string fileName = string(directory) + "/" + entry.file ;
+	if(!ifstream(fileName.c_str())) {
+		cerr << fileName << ": cannot be read" << endl ;
+		return false ;
+	}
+	graph = readGraphFromMatrix(fileName.c_str()) ;
+	if(graphHash(graph) != entry.hash) {
+		cerr << fileName << ": does not match its hash " << hexHash(entry.hash) << endl ;
+		return false ;
+	}
+	return true ;
+}
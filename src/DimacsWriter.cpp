@@ -0,0 +1,101 @@
+//Streaming DIMACS output
+//The integers are converted by hand and the text accumulates in a buffer of
+//DIMACS_BUFFER bytes, the target only sees large writes.
+
+#include "../include/DimacsWriter.h"
+#include <zlib.h>
+
+#define DIMACS_MEMORY   3 //target is a string
+
+//longest text of a literal: sign, 10 digits and the separator
+#define LITERAL_TEXT    12
+
+//writes x in decimal at out, returns the end of the text
+static inline char* writeInt(char* out, long x) {
+	unsigned long u = x ;
+	if(x < 0) {
+		*out++ = '-' ;
+		u = -(unsigned long) x ;
+	}
+	char tmp[20] ;
+	int len = 0 ;
+	do {
+		tmp[len++] = '0' + u % 10 ;
+		u /= 10 ;
+	} while(u != 0) ;
+	while(len > 0)
+		*out++ = tmp[--len] ;
+	return out ;
+}
+
+DimacsWriter::DimacsWriter(const char* target, int mode) :
+	mode(mode), ok(true), file(NULL), gz(NULL), memory(NULL), buffer(DIMACS_BUFFER), used(0) {
+	if(mode == DIMACS_GZIP)
+		gz = gzopen(target, "wb1") ; //fastest level, CNF text compresses well anyway
+	else if(mode == DIMACS_PIPE)
+		file = popen(target, "w") ;
+	else
+		file = fopen(target, "wb") ;
+	ok = file != NULL || gz != NULL ;
+}
+
+DimacsWriter::DimacsWriter(string& memory) :
+	mode(DIMACS_MEMORY), ok(true), file(NULL), gz(NULL), memory(&memory), buffer(DIMACS_BUFFER), used(0) {}
+
+DimacsWriter::~DimacsWriter() {
+	close() ;
+}
+
+bool DimacsWriter::close() {
+	flush() ;
+	if(gz != NULL)
+		ok = gzclose((gzFile) gz) == Z_OK && ok ;
+	else if(file != NULL && mode == DIMACS_PIPE)
+		ok = pclose(file) == 0 && ok ;
+	else if(file != NULL)
+		ok = fclose(file) == 0 && ok ;
+	gz = NULL ;
+	file = NULL ;
+	return ok ;
+}
+
+void DimacsWriter::flush() {
+	if(used == 0)
+		return ;
+	if(mode == DIMACS_MEMORY)
+		memory->append(&buffer[0], used) ;
+	else if(gz != NULL)
+		ok = ok && gzwrite((gzFile) gz, &buffer[0], used) == (int) used ;
+	else if(file != NULL)
+		ok = ok && fwrite(&buffer[0], 1, used, file) == used ;
+	used = 0 ;
+}
+
+void DimacsWriter::begin(int nbVar, long nbClauses) {
+	char* out = &buffer[used] ;
+	const char header[] = "p cnf " ;
+	for(const char* c = header ; *c != '\0' ; c++)
+		*out++ = *c ;
+	out = writeInt(out, nbVar) ;
+	*out++ = ' ' ;
+	out = writeInt(out, nbClauses) ;
+	*out++ = '\n' ;
+	used = out - &buffer[0] ;
+}
+
+void DimacsWriter::addClause(const vector<int>& clause) {
+	size_t need = (clause.size() + 1) * LITERAL_TEXT ;
+	if(used + need > buffer.size()) {
+		flush() ;
+		if(need > buffer.size())
+			buffer.resize(need) ;
+	}
+	char* out = &buffer[used] ;
+	for(size_t i = 0 ; i < clause.size() ; i++) {
+		out = writeInt(out, clause[i]) ;
+		*out++ = ' ' ;
+	}
+	*out++ = '0' ;
+	*out++ = '\n' ;
+	used = out - &buffer[0] ;
+}
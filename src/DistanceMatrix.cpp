@@ -0,0 +1,119 @@
+#include "../include/DistanceMatrix.h"
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <utility>
+
+#ifdef _MSC_VER // Windows
+#include <malloc.h>
+#endif
+
+static size_t elementSize(ElementWidth width) {
+	switch(width) {
+	case WIDTH8 :
+		return 1 ;
+	case WIDTH16 :
+		return 2 ;
+	default :
+		return 4 ;
+	}
+}
+
+static void* alignedAlloc(size_t bytes) {
+	if(bytes == 0)
+		return NULL ;
+#ifdef _MSC_VER
+	void* p = _aligned_malloc(bytes, MATRIX_ALIGNMENT) ;
+#else
+	void* p = NULL ;
+	if(posix_memalign(&p, MATRIX_ALIGNMENT, bytes) != 0)
+		p = NULL ;
+#endif
+	if(p == NULL)
+		throw std::bad_alloc() ;
+	return p ;
+}
+
+static void alignedFree(void* p) {
+#ifdef _MSC_VER
+	_aligned_free(p) ;
+#else
+	free(p) ;
+#endif
+}
+
+ElementWidth widthFor(int maxWeight) {
+	if(maxWeight <= UINT8_MAX)
+		return WIDTH8 ;
+	if(maxWeight <= UINT16_MAX)
+		return WIDTH16 ;
+	return WIDTH32 ;
+}
+
+DistanceMatrix::DistanceMatrix() : n(0), rowStride(0), elemWidth(WIDTH32), data(NULL) {
+}
+
+DistanceMatrix::DistanceMatrix(int n, ElementWidth width, int fill) : n(n), elemWidth(width) {
+	/* each row is padded so that the next one starts on an aligned boundary */
+	size_t perLine = MATRIX_ALIGNMENT / elementSize(width) ;
+	rowStride = (int) (((size_t) n + perLine - 1) / perLine * perLine) ;
+	size_t bytes = (size_t) n * rowStride * elementSize(width) ;
+	data = alignedAlloc(bytes) ;
+	if(bytes > 0)
+		memset(data, 0, bytes) ;
+	if(fill != 0)
+		for(int i = 0 ; i < n ; i++)
+			for(int j = 0 ; j < n ; j++)
+				set(i, j, fill) ;
+}
+
+DistanceMatrix::DistanceMatrix(const DistanceMatrix& other) : n(other.n), rowStride(other.rowStride), elemWidth(other.elemWidth) {
+	size_t bytes = (size_t) n * rowStride * elementSize(elemWidth) ;
+	data = alignedAlloc(bytes) ;
+	if(bytes > 0)
+		memcpy(data, other.data, bytes) ;
+}
+
+DistanceMatrix::DistanceMatrix(DistanceMatrix&& other) : n(other.n), rowStride(other.rowStride), elemWidth(other.elemWidth), data(other.data) {
+	other.n = other.rowStride = 0 ;
+	other.data = NULL ;
+}
+
+DistanceMatrix& DistanceMatrix::operator=(DistanceMatrix other) {
+	swap(*this, other) ;
+	return *this ;
+}
+
+DistanceMatrix::~DistanceMatrix() {
+	alignedFree(data) ;
+}
+
+void swap(DistanceMatrix& a, DistanceMatrix& b) {
+	std::swap(a.n, b.n) ;
+	std::swap(a.rowStride, b.rowStride) ;
+	std::swap(a.elemWidth, b.elemWidth) ;
+	std::swap(a.data, b.data) ;
+}
+
+void DistanceMatrix::set(int i, int j, int weight) {
+	size_t k = (size_t) i * rowStride + j ;
+	switch(elemWidth) {
+	case WIDTH8 :
+		((uint8_t*) data)[k] = (uint8_t) weight ;
+		break ;
+	case WIDTH16 :
+		((uint16_t*) data)[k] = (uint16_t) weight ;
+		break ;
+	default :
+		((int32_t*) data)[k] = (int32_t) weight ;
+	}
+}
+
+int DistanceMatrix::maxWeight() const {
+	int res = 0 ;
+	for(int i = 0 ; i < n ; i++)
+		for(int j = 0 ; j < n ; j++)
+			if((*this)(i, j) > res)
+				res = (*this)(i, j) ;
+	return res ;
+}
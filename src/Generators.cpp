@@ -0,0 +1,153 @@
+//Random instance generators
+//The DISCRETE graphs start from a matrix full of heavy edges and only set
+//their m edges, so that generating them costs O(n + m) draws on top of
+//filling the matrix, instead of one coin flip per pair of vertices.
+
+#include "../include/Generators.h"
+#include "../include/Random.h"
+#include <algorithm>
+#include <cmath>
+#include <unordered_set>
+#include <vector>
+
+using namespace std ;
+
+static DistanceMatrix emptyGraph(int n) {
+	DistanceMatrix res (n, WIDTH8, 10) ;
+	for(int i = 0 ; i < n ; i++)
+		res.set(i, i, 0) ;
+	return res ;
+}
+
+static void addEdge(DistanceMatrix& graph, int u, int v) {
+	graph.set(u, v, 1) ;
+	graph.set(v, u, 1) ;
+}
+
+//Batagelj and Brandes: the pairs (v, w), w < v, are walked in order and the
+//gap to the next edge follows a geometric law of parameter p
+DistanceMatrix gnp(int n, double p, uint64_t seed) {
+	DistanceMatrix res = emptyGraph(n) ;
+	if(p <= 0)
+		return res ;
+	if(p >= 1) {
+		for(int v = 1 ; v < n ; v++)
+			for(int w = 0 ; w < v ; w++)
+				addEdge(res, v, w) ;
+		return res ;
+	}
+	Random rng (seed) ;
+	double logq = log(1 - p) ;
+	long long v = 1, w = -1 ;
+	while(v < n) {
+		w += 1 + (long long) floor(log(1 - rng.uniform()) / logq) ;
+		while(w >= v && v < n) {
+			w -= v ;
+			v++ ;
+		}
+		if(v < n)
+			addEdge(res, v, w) ;
+	}
+	return res ;
+}
+
+//pair (v, w), w < v, of index k = v (v - 1) / 2 + w
+static void pairOf(long long k, int& v, int& w) {
+	long long x = (long long) ((1 + sqrt(1 + 8.0 * k)) / 2) ;
+	while(x * (x - 1) / 2 > k)
+		x-- ;
+	while((x + 1) * x / 2 <= k)
+		x++ ;
+	v = x ;
+	w = k - x * (x - 1) / 2 ;
+}
+
+//Floyd's sampling of m distinct pair indices; beyond half of the pairs the
+//non-edges are sampled instead
+DistanceMatrix gnm(int n, long long m, uint64_t seed) {
+	long long pairs = (long long) n * (n - 1) / 2 ;
+	m = max(0LL, min(m, pairs)) ;
+	bool complement = m > pairs / 2 ;
+	long long k = complement ? pairs - m : m ;
+
+	Random rng (seed) ;
+	unordered_set<long long> chosen ;
+	chosen.reserve(k) ;
+	for(long long j = pairs - k ; j < pairs ; j++) {
+		long long t = rng.below(j + 1) ;
+		chosen.insert(chosen.count(t) ? j : t) ;
+	}
+
+	DistanceMatrix res = emptyGraph(n) ;
+	int v, w ;
+	if(!complement) {
+		for(unordered_set<long long>::const_iterator it = chosen.begin() ; it != chosen.end() ; ++it) {
+			pairOf(*it, v, w) ;
+			addEdge(res, v, w) ;
+		}
+		return res ;
+	}
+	for(long long e = 0 ; e < pairs ; e++) {
+		if(chosen.count(e))
+			continue ;
+		pairOf(e, v, w) ;
+		addEdge(res, v, w) ;
+	}
+	return res ;
+}
+
+DistanceMatrix randomGeometric(int n, double radius, uint64_t seed) {
+	DistanceMatrix res = emptyGraph(n) ;
+	if(n == 0 || radius <= 0)
+		return res ;
+	Random rng (seed) ;
+	vector<double> x (n), y (n) ;
+	for(int i = 0 ; i < n ; i++) {
+		x[i] = rng.uniform() ;
+		y[i] = rng.uniform() ;
+	}
+
+	//cells at least radius wide: the neighbours of a point are in the 3 x 3
+	//cells around its own, there are no more cells than points
+	int side = max(1, min((int) (1 / radius), (int) sqrt((double) n))) ;
+	vector<vector<int> > cells (side * side) ;
+	vector<int> cx (n), cy (n) ;
+	for(int i = 0 ; i < n ; i++) {
+		cx[i] = min((int) (x[i] * side), side - 1) ;
+		cy[i] = min((int) (y[i] * side), side - 1) ;
+		cells[cy[i] * side + cx[i]].push_back(i) ;
+	}
+	double r2 = radius * radius ;
+	for(int i = 0 ; i < n ; i++) {
+		for(int a = max(cx[i] - 1, 0) ; a <= min(cx[i] + 1, side - 1) ; a++) {
+			for(int b = max(cy[i] - 1, 0) ; b <= min(cy[i] + 1, side - 1) ; b++) {
+				const vector<int>& cell = cells[b * side + a] ;
+				for(size_t c = 0 ; c < cell.size() ; c++) {
+					int j = cell[c] ;
+					double dx = x[i] - x[j], dy = y[i] - y[j] ;
+					if(j > i && dx * dx + dy * dy <= r2)
+						addEdge(res, i, j) ;
+				}
+			}
+		}
+	}
+	return res ;
+}
+
+DistanceMatrix euclidean(int n, int side, uint64_t seed) {
+	Random rng (seed) ;
+	vector<double> x (n), y (n) ;
+	for(int i = 0 ; i < n ; i++) {
+		x[i] = rng.uniform() * side ;
+		y[i] = rng.uniform() * side ;
+	}
+	DistanceMatrix res (n, widthFor((int) ceil(side * sqrt(2.0)) + 1)) ;
+	for(int i = 0 ; i < n ; i++) {
+		for(int j = i + 1 ; j < n ; j++) {
+			int weight = max(1, (int) lround(hypot(x[i] - x[j], y[i] - y[j]))) ;
+			res.set(i, j, weight) ;
+			res.set(j, i, weight) ;
+		}
+	}
+	return res ;
+}
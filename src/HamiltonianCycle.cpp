@@ -0,0 +1,186 @@
+//Dynamic programming over the subsets of vertices on the bitset adjacency
+//Every subset S holds a 32-bit mask of vertices and gets one contribution
+//per vertex v of S, computed from the mask of S \ {v} and the neighbours of
+//v. The subsets are split in blocks of 2^SUBSET_BLOCK_BITS sharing their high
+//bits: a block only depends on itself and on the blocks with one high bit
+//less, the blocks with the same number of high bits are computed in
+//parallel, and a contribution from another block (or from another group of
+//8 subsets in the block) is an element-wise operation on 8 masks at once.
+
+#include "../include/Algorithmic.h"
+#include "../include/BitGraph.h"
+#include "../include/Parallel.h"
+#include <algorithm>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#define SUBSET_BLOCK_BITS 12 //a block of 2^12 masks fits in the L1 cache
+
+#define COVER_COUNT  0xFF000000u //path cover: number of paths in the high byte,
+#define COVER_ONE    0x01000000u //possible ends of the last path in the low bits
+#define COVER_NONE   0x7F000000u //not covered yet
+
+//Hamiltonian cycle: bit v set when a path of graph edges starts at vertex 0,
+//visits exactly S and ends at v
+struct ReachStep {
+	static inline uint32_t apply(uint32_t mask, uint32_t prev, uint32_t adj, uint32_t vertex) {
+		return (prev & adj) ? mask | vertex : mask ;
+	}
+#if defined(__AVX2__)
+	static inline __m256i apply(__m256i mask, __m256i prev, __m256i adj, __m256i vertex) {
+		__m256i miss = _mm256_cmpeq_epi32(_mm256_and_si256(prev, adj), _mm256_setzero_si256()) ;
+		return _mm256_or_si256(mask, _mm256_andnot_si256(miss, vertex)) ;
+	}
+#endif
+} ;
+
+//path cover: the fewest paths covering S, and the vertices ending the last
+//of them. The other ends are not needed, they cost one more path, as much
+//as starting a new one.
+struct CoverStep {
+	static inline uint32_t apply(uint32_t mask, uint32_t prev, uint32_t adj, uint32_t vertex) {
+		uint32_t count = (prev & COVER_COUNT) + ((prev & adj) ? 0 : COVER_ONE) ;
+		if(count < (mask & COVER_COUNT))
+			return count | vertex ;
+		return count == (mask & COVER_COUNT) ? mask | vertex : mask ;
+	}
+#if defined(__AVX2__)
+	static inline __m256i apply(__m256i mask, __m256i prev, __m256i adj, __m256i vertex) {
+		__m256i miss = _mm256_cmpeq_epi32(_mm256_and_si256(prev, adj), _mm256_setzero_si256()) ;
+		__m256i count = _mm256_add_epi32(_mm256_and_si256(prev, _mm256_set1_epi32(COVER_COUNT)), _mm256_and_si256(miss, _mm256_set1_epi32(COVER_ONE))) ;
+		__m256i current = _mm256_and_si256(mask, _mm256_set1_epi32(COVER_COUNT)) ;
+		//the counts stay below 2^31, the signed comparison is enough
+		__m256i better = _mm256_cmpgt_epi32(current, count) ;
+		__m256i same = _mm256_cmpeq_epi32(current, count) ;
+		mask = _mm256_blendv_epi8(mask, _mm256_or_si256(count, vertex), better) ;
+		return _mm256_or_si256(mask, _mm256_and_si256(same, vertex)) ;
+	}
+#endif
+} ;
+
+//contribution of the vertex to 'count' consecutive subsets (a multiple of 8)
+template<typename Step>
+inline void contribute(uint32_t* mask, const uint32_t* prev, size_t count, uint32_t adj, uint32_t vertex) {
+#if defined(__AVX2__)
+	__m256i a = _mm256_set1_epi32(adj), v = _mm256_set1_epi32(vertex) ;
+	for(size_t i = 0 ; i < count ; i += 8) {
+		__m256i m = _mm256_loadu_si256((const __m256i*) (mask + i)) ;
+		__m256i p = _mm256_loadu_si256((const __m256i*) (prev + i)) ;
+		_mm256_storeu_si256((__m256i*) (mask + i), Step::apply(m, p, a, v)) ;
+	}
+#else
+	for(size_t i = 0 ; i < count ; i++)
+		mask[i] = Step::apply(mask[i], prev[i], adj, vertex) ;
+#endif
+}
+
+//fills table[S] for the subsets S of 'bits' elements, the element b being
+//the vertex whose mask is vertex[b] and whose neighbours are adj[b]. The
+//table holds the initial masks.
+template<typename Step>
+void subsetDP(vector<uint32_t>& table, int bits, const vector<uint32_t>& adj, const vector<uint32_t>& vertex, int threads) {
+	if(bits < 3) {
+		for(size_t S = 1 ; S < table.size() ; S++)
+			for(int b = 0 ; b < bits ; b++)
+				if((S >> b) & 1)
+					table[S] = Step::apply(table[S], table[S ^ ((size_t) 1 << b)], adj[b], vertex[b]) ;
+		return ;
+	}
+
+	int low = bits < SUBSET_BLOCK_BITS ? bits : SUBSET_BLOCK_BITS ;
+	int high = bits - low ;
+	size_t blockSize = (size_t) 1 << low ;
+	vector<vector<uint32_t> > layers (high + 1) ;
+	for(uint32_t hi = 0 ; hi < ((uint32_t) 1 << high) ; hi++)
+		layers[__builtin_popcount(hi)].push_back(hi) ;
+
+	for(int layer = 0 ; layer <= high ; layer++) {
+		parallelFor(layers[layer].size(), [&](int i, int) {
+			uint32_t hi = layers[layer][i] ;
+			uint32_t* block = &table[(size_t) hi << low] ;
+			for(uint32_t h = hi ; h ; h &= h - 1) {
+				int b = __builtin_ctz(h) + low ;
+				contribute<Step>(block, block - ((size_t) 1 << b), blockSize, adj[b], vertex[b]) ;
+			}
+			//groups of 8 subsets in increasing order, the 3 lowest bits inside a group
+			for(size_t group = 0 ; group < blockSize ; group += 8) {
+				for(int b = 3 ; b < low ; b++)
+					if((group >> b) & 1)
+						contribute<Step>(block + group, block + (group ^ ((size_t) 1 << b)), 8, adj[b], vertex[b]) ;
+				for(size_t S = group ; S < group + 8 ; S++)
+					for(int b = 0 ; b < 3 ; b++)
+						if((S >> b) & 1)
+							block[S] = Step::apply(block[S], block[S ^ ((size_t) 1 << b)], adj[b], vertex[b]) ;
+			}
+		}, threads) ;
+	}
+}
+
+bool hamiltonianCycle(const BitGraph& g, vector<int>& tour, int threads) {
+	int n = g.size() ;
+	if(n < 3 || n > HAMILTONIAN_MAX)
+		return false ;
+	//vertex v > 0 is the element v-1 of the subsets, the empty path ends at 0
+	int m = n - 1 ;
+	vector<uint32_t> adj (m), vertex (m) ;
+	for(int b = 0 ; b < m ; b++) {
+		adj[b] = (uint32_t) g.row(b + 1)[0] ;
+		vertex[b] = (uint32_t) 1 << (b + 1) ;
+	}
+	vector<uint32_t> reach ((size_t) 1 << m, 0) ;
+	reach[0] = 1 ;
+	subsetDP<ReachStep>(reach, m, adj, vertex, threads) ;
+
+	size_t full = reach.size() - 1 ;
+	uint32_t last = reach[full] & (uint32_t) g.row(0)[0] ;
+	if(!last)
+		return false ;
+	tour.assign(1, 0) ;
+	int v = __builtin_ctz(last) ;
+	for(size_t S = full ; S ; ) {
+		tour.push_back(v) ;
+		S ^= (size_t) 1 << (v - 1) ;
+		if(S)
+			v = __builtin_ctz(reach[S] & adj[v - 1]) ;
+	}
+	return true ;
+}
+
+bool hamiltonianCycle(const DistanceMatrix& graph, vector<int>& tour, int threads) {
+	if(graph.size() > HAMILTONIAN_MAX)
+		return false ;
+	BitGraph g (graph) ;
+	return hamiltonianCycle(g, tour, threads) ;
+}
+
+vector<int> minimumPathCover(const BitGraph& g, int threads) {
+	int n = g.size() ;
+	vector<uint32_t> adj (n), vertex (n) ;
+	for(int v = 0 ; v < n ; v++) {
+		adj[v] = (uint32_t) g.row(v)[0] ;
+		vertex[v] = (uint32_t) 1 << v ;
+	}
+	vector<uint32_t> cover ((size_t) 1 << n, COVER_NONE) ;
+	cover[0] = 0 ;
+	subsetDP<CoverStep>(cover, n, adj, vertex, threads) ;
+
+	//the paths are rebuilt from the end, an end with no predecessor in the
+	//same path starts a new one
+	vector<int> tour ;
+	size_t S = cover.size() - 1 ;
+	int v = __builtin_ctz(cover[S] & ~COVER_COUNT) ;
+	while(S) {
+		tour.push_back(v) ;
+		size_t prev = S ^ ((size_t) 1 << v) ;
+		if(prev) {
+			uint32_t ends = cover[prev] & ~COVER_COUNT ;
+			bool sameCount = (cover[prev] & COVER_COUNT) == (cover[S] & COVER_COUNT) ;
+			v = __builtin_ctz(sameCount && (ends & adj[v]) ? ends & adj[v] : ends) ;
+		}
+		S = prev ;
+	}
+	reverse(tour.begin(), tour.end()) ;
+	return tour ;
+}
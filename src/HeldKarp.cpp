@@ -0,0 +1,150 @@
+//Held-Karp dynamic programming over the subsets of vertices
+//dp[S][j] is the length of the shortest path starting at vertex 0, visiting
+//every vertex of S exactly once and ending at j (j in S, 0 not in S). Only
+//the j in S are stored: the row of S holds popcount(S) costs, in the order
+//of the bits of S, and the rows follow each other in the order of the
+//subsets, m 2^(m-1) costs in all.
+
+#include "../include/Algorithmic.h"
+#include "../include/Parallel.h"
+#include <iostream>
+#include <limits>
+#include <stdint.h>
+
+//start of the row of S: the sum of popcount(T) over the subsets T < S. For
+//each bit b of S, the T sharing the bits of S above b and without b have
+//'above' bits there and b 2^(b-1) bits below b in all.
+static inline size_t rowOffset(size_t S) {
+	size_t res = 0 ;
+	int above = 0 ;
+	for(int b = 63 ; b >= 0 ; b--) {
+		if(!(S & ((size_t) 1 << b)))
+			continue ;
+		res += ((size_t) above << b) + (b ? (size_t) b << (b - 1) : 0) ;
+		above++ ;
+	}
+	return res ;
+}
+
+//start of the row of S \ {j}, j in S, from the start of the row of S: the
+//term of j goes away and each lower bit of S has one bit less above it
+static inline size_t rowOffsetWithout(size_t S, size_t offset, int j) {
+	size_t above = __builtin_popcountll(S >> j >> 1) ;
+	return offset - (above << j) - (j ? (size_t) j << (j - 1) : 0) - (S & (((size_t) 1 << j) - 1)) ;
+}
+
+//position of j in the row of S
+static inline int rankIn(size_t S, int j) {
+	return __builtin_popcountll(S & (((size_t) 1 << j) - 1)) ;
+}
+
+template<typename Cost>
+vector<int> heldKarp_(const DistanceMatrix& graph, int type) {
+	int n = graph.size() ;
+	int m = n - 1 ; //vertex v > 0 is stored as bit v-1
+	size_t nbSubsets = (size_t) 1 << m ;
+	const Cost INF = numeric_limits<Cost>::max() ;
+
+	vector<int> cost ((size_t) n * n) ;
+	for(int u = 0 ; u < n ; u++)
+		for(int v = 0 ; v < n ; v++)
+			cost[(size_t) u * n + v] = edgeCost(graph, u, v, type) ;
+
+	//the predecessors of (S, j) are read from the contiguous row of S \ {j}
+	vector<Cost> dp ((size_t) m << (m - 1), INF) ;
+	for(int j = 0 ; j < m ; j++)
+		dp[rowOffset((size_t) 1 << j)] = cost[j + 1] ;
+
+	//subsets of the same size only depend on the previous layer, each layer is split in contiguous chunks
+	int threads = hardwareThreads() ;
+	size_t nbChunks = (size_t) threads * 16 ;
+	if(nbChunks > nbSubsets)
+		nbChunks = nbSubsets ;
+	size_t chunkSize = (nbSubsets + nbChunks - 1) / nbChunks ;
+
+	for(int layer = 2 ; layer <= m ; layer++) {
+		parallelFor(nbChunks, [&](int chunk, int) {
+			size_t begin = chunk * chunkSize ;
+			size_t end = begin + chunkSize < nbSubsets ? begin + chunkSize : nbSubsets ;
+			for(size_t S = begin ; S < end ; S++) {
+				if(__builtin_popcountll(S) != layer)
+					continue ;
+				size_t offset = rowOffset(S) ;
+				Cost* out = &dp[offset] ;
+				for(size_t js = S ; js ; js &= js - 1) {
+					int j = __builtin_ctzll(js) ;
+					size_t prev = S ^ ((size_t) 1 << j) ;
+					const Cost* row = &dp[rowOffsetWithout(S, offset, j)] ;
+					const int* toJ = &cost[(size_t) (j + 1) * n + 1] ;
+					int best = numeric_limits<int>::max() ;
+					int k = 0 ;
+					for(size_t is = prev ; is ; is &= is - 1, k++) {
+						int tmp = row[k] + toJ[__builtin_ctzll(is)] ;
+						if(tmp < best)
+							best = tmp ;
+					}
+					*out++ = (Cost) best ;
+				}
+			}
+		}, threads) ;
+	}
+
+	//we close the cycle and rebuild the tour from its end
+	size_t full = nbSubsets - 1 ;
+	const Cost* fullRow = &dp[rowOffset(full)] ;
+	int last = 0 ;
+	int best = numeric_limits<int>::max() ;
+	for(int j = 0 ; j < m ; j++) {
+		int tmp = fullRow[j] + cost[(size_t) (j + 1) * n] ;
+		if(tmp < best) {
+			best = tmp ;
+			last = j ;
+		}
+	}
+
+	vector<int> tour (n) ;
+	size_t S = full ;
+	for(int pos = n - 1 ; pos > 0 ; pos--) {
+		tour[pos] = last + 1 ;
+		size_t prev = S ^ ((size_t) 1 << last) ;
+		Cost value = dp[rowOffset(S) + rankIn(S, last)] ;
+		const Cost* row = &dp[rowOffset(prev)] ;
+		int k = 0 ;
+		for(size_t is = prev ; is ; is &= is - 1, k++) {
+			int i = __builtin_ctzll(is) ;
+			if(row[k] + cost[(size_t) (i + 1) * n + last + 1] == value) {
+				last = i ;
+				break ;
+			}
+		}
+		S = prev ;
+	}
+	tour[0] = 0 ;
+	return tour ;
+}
+
+vector<int> heldKarp(const DistanceMatrix& graph, int type) {
+	int n = graph.size() ;
+	if(n <= 3) {
+		vector<int> tour (n) ;
+		for(int i = 0 ; i < n ; i++)
+			tour[i] = i ;
+		return tour ;
+	}
+	if(n > HELDKARP_MAX) {
+		cerr << "heldKarp: " << n << " vertices, at most " << HELDKARP_MAX << " are supported" << endl ;
+		return vector<int>() ;
+	}
+
+	//the narrowest cost type able to hold the length of any tour
+	long maxCost = 0 ;
+	for(int u = 0 ; u < n ; u++)
+		for(int v = 0 ; v < n ; v++)
+			if(edgeCost(graph, u, v, type) > maxCost)
+				maxCost = edgeCost(graph, u, v, type) ;
+	if(maxCost * n < numeric_limits<uint8_t>::max())
+		return heldKarp_<uint8_t>(graph, type) ;
+	if(maxCost * n < numeric_limits<uint16_t>::max())
+		return heldKarp_<uint16_t>(graph, type) ;
+	return heldKarp_<uint32_t>(graph, type) ;
+}
@@ -0,0 +1,372 @@
+//Lin-Kernighan style local search
+//Variable depth chains of 2-opt moves: the edge (t1,t2) is removed, t2 is
+//joined to a close t3 and the tour edge (t3,t4) is dropped so that closing
+//with (t4,t1) gives back a tour, then the search goes on from (t1,t4). The
+//chain is cut back to its most profitable prefix. Independent restarts from
+//randomly kicked MST tours run in parallel and the best tour is returned.
+//The tour is a two-level list (segments of about sqrt(n) cities with a
+//reversal bit) so that reversing a path costs O(sqrt(n)) instead of O(n).
+
+#include "../include/Algorithmic.h"
+#include "../include/Parallel.h"
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <random>
+
+#define LK_NEIGHBOURS 10  //size of the candidate lists
+#define LK_DEPTH 50       //longest chain of moves
+#define LK_MIN_SIZE 8     //smaller graphs only get improveTour
+
+class TwoLevelList {
+public:
+	TwoLevelList(const vector<int>& tour) : seg(tour.size()), idx(tour.size()) {
+		int n = tour.size() ;
+		groupSize = max(8, (int) sqrt((double) n)) ;
+		build(tour) ;
+	}
+
+	int size() const { return seg.size() ; }
+
+	int next(int v) const {
+		const Segment& s = segs[seg[v]] ;
+		int i = idx[v] ;
+		if(!s.reversed && i + 1 < (int) s.cities.size())
+			return s.cities[i + 1] ;
+		if(s.reversed && i > 0)
+			return s.cities[i - 1] ;
+		return first(order[s.rank + 1 == (int) order.size() ? 0 : s.rank + 1]) ;
+	}
+
+	int prev(int v) const {
+		const Segment& s = segs[seg[v]] ;
+		int i = idx[v] ;
+		if(!s.reversed && i > 0)
+			return s.cities[i - 1] ;
+		if(s.reversed && i + 1 < (int) s.cities.size())
+			return s.cities[i + 1] ;
+		return last(order[s.rank == 0 ? order.size() - 1 : s.rank - 1]) ;
+	}
+
+	//reverses the path from x to y (following next), or the rest of the tour
+	void reversePath(int x, int y) {
+		if(x == y)
+			return ;
+		if(seg[x] == seg[y]) {
+			int px = position(x), py = position(y) ;
+			if(px <= py) {
+				reverseInside(x, y) ;
+				return ;
+			}
+			if(px == py + 1)
+				return ; //the whole tour
+			reverseInside(next(y), prev(x)) ;
+			return ;
+		}
+		if(next(y) == x)
+			return ;
+
+		splitBefore(x) ;
+		splitBefore(next(y)) ;
+		int m = order.size() ;
+		int a = segs[seg[x]].rank, b = segs[seg[y]].rank ;
+		int count = (b - a + m) % m + 1 ;
+		if(2 * count > m) {
+			int tmp = a ;
+			a = (b + 1) % m ;
+			b = (tmp - 1 + m) % m ;
+			count = m - count ;
+		}
+		for(int k = 0 ; k < count / 2 ; k++) {
+			swap(order[a], order[b]) ;
+			a = a + 1 == m ? 0 : a + 1 ;
+			b = b == 0 ? m - 1 : b - 1 ;
+		}
+		//a and b met in the middle, every segment of the range is flipped
+		int start = (a - count / 2 + m) % m ;
+		for(int k = 0 ; k < count ; k++) {
+			int s = order[(start + k) % m] ;
+			segs[s].reversed = !segs[s].reversed ;
+			segs[s].rank = (start + k) % m ;
+		}
+
+		if((int) order.size() > 2 * ((size() + groupSize - 1) / groupSize) + 8)
+			build(toVector()) ;
+	}
+
+	//replaces the edges (a,b) and (c,d) by (a,c) and (b,d), where d follows c
+	//in the direction b follows a: d is implied by a, b and c
+	void move(int a, int b, int c) {
+		if(next(a) == b)
+			reversePath(b, c) ;
+		else
+			reversePath(c, b) ;
+	}
+
+	vector<int> toVector() const {
+		vector<int> tour ;
+		tour.reserve(size()) ;
+		for(size_t k = 0 ; k < order.size() ; k++) {
+			const Segment& s = segs[order[k]] ;
+			if(s.reversed)
+				tour.insert(tour.end(), s.cities.rbegin(), s.cities.rend()) ;
+			else
+				tour.insert(tour.end(), s.cities.begin(), s.cities.end()) ;
+		}
+		return tour ;
+	}
+
+private:
+	struct Segment {
+		vector<int> cities ;
+		bool reversed ;
+		int rank ; //index in order
+	} ;
+
+	vector<Segment> segs ;
+	vector<int> order ; //segments in tour order
+	vector<int> seg ;   //segment of every city
+	vector<int> idx ;   //index of every city in its segment
+	int groupSize ;
+
+	int first(int s) const { return segs[s].reversed ? segs[s].cities.back() : segs[s].cities.front() ; }
+	int last(int s) const { return segs[s].reversed ? segs[s].cities.front() : segs[s].cities.back() ; }
+
+	//position of v along the tour direction inside its segment
+	int position(int v) const {
+		const Segment& s = segs[seg[v]] ;
+		return s.reversed ? s.cities.size() - 1 - idx[v] : idx[v] ;
+	}
+
+	void build(const vector<int>& tour) {
+		int n = tour.size() ;
+		segs.clear() ;
+		order.clear() ;
+		for(int i = 0 ; i < n ; i += groupSize) {
+			Segment s ;
+			s.cities.assign(tour.begin() + i, tour.begin() + min(n, i + groupSize)) ;
+			s.reversed = false ;
+			s.rank = segs.size() ;
+			order.push_back(segs.size()) ;
+			segs.push_back(s) ;
+			reindex(segs.size() - 1, 0) ;
+		}
+	}
+
+	void reindex(int s, int from) {
+		for(int i = from ; i < (int) segs[s].cities.size() ; i++) {
+			seg[segs[s].cities[i]] = s ;
+			idx[segs[s].cities[i]] = i ;
+		}
+	}
+
+	//reverses the path x..y lying inside one segment
+	void reverseInside(int x, int y) {
+		int s = seg[x] ;
+		int i = min(idx[x], idx[y]), j = max(idx[x], idx[y]) ;
+		reverse(segs[s].cities.begin() + i, segs[s].cities.begin() + j + 1) ;
+		for(int k = i ; k <= j ; k++)
+			idx[segs[s].cities[k]] = k ;
+	}
+
+	//cuts the segment of v so that v starts a segment
+	void splitBefore(int v) {
+		int s = seg[v] ;
+		if(position(v) == 0)
+			return ;
+		int t = segs.size() ;
+		segs.push_back(Segment()) ;
+		Segment& S = segs[s] ;
+		Segment& T = segs[t] ;
+		T.reversed = S.reversed ;
+		if(!S.reversed) {
+			T.cities.assign(S.cities.begin() + idx[v], S.cities.end()) ;
+			S.cities.resize(idx[v]) ;
+		}
+		else {
+			T.cities.assign(S.cities.begin(), S.cities.begin() + idx[v] + 1) ;
+			S.cities.erase(S.cities.begin(), S.cities.begin() + idx[v] + 1) ;
+			reindex(s, 0) ;
+		}
+		reindex(t, 0) ;
+		order.insert(order.begin() + S.rank + 1, t) ;
+		for(int k = S.rank + 1 ; k < (int) order.size() ; k++)
+			segs[order[k]].rank = k ;
+	}
+} ;
+
+struct LinKernighanSearch {
+	const DistanceMatrix& graph ;
+	int type ;
+	TwoLevelList& tour ;
+	const vector<vector<int> >& neighbours ;
+	deque<int> queue ;
+	vector<char> queued ;
+	vector<pair<int, int> > added ;
+	vector<int> moves ; //4 cities per applied move
+
+	LinKernighanSearch(const DistanceMatrix& graph, int type, TwoLevelList& tour, const vector<vector<int> >& neighbours) :
+		graph(graph), type(type), tour(tour), neighbours(neighbours), queued(tour.size(), 0) {}
+
+	inline int cost(int u, int v) const { return edgeCost(graph, u, v, type) ; }
+
+	void push(int v) {
+		if(!queued[v]) {
+			queued[v] = 1 ;
+			queue.push_back(v) ;
+		}
+	}
+
+	bool isAdded(int u, int v) const {
+		for(size_t k = 0 ; k < added.size() ; k++)
+			if((added[k].first == u && added[k].second == v) || (added[k].first == v && added[k].second == u))
+				return true ;
+		return false ;
+	}
+
+	//the t4 closing the move removing (t1,t2) and (t3,t4)
+	inline int partner(int t1, int t2, int t3) const {
+		return tour.next(t1) == t2 ? tour.prev(t3) : tour.next(t3) ;
+	}
+
+	void apply(int t1, int t2, int t3, int t4) {
+		tour.move(t1, t2, t4) ;
+		moves.push_back(t1) ;
+		moves.push_back(t2) ;
+		moves.push_back(t3) ;
+		moves.push_back(t4) ;
+		added.push_back(make_pair(t2, t3)) ;
+	}
+
+	//chain starting by removing (t1,t2) and adding (t2,t3), true if kept
+	bool chain(int t1, int t2, int t3) {
+		moves.clear() ;
+		added.clear() ;
+		int t4 = partner(t1, t2, t3) ;
+		int g = cost(t1, t2) - cost(t2, t3) + cost(t3, t4) ;
+		apply(t1, t2, t3, t4) ;
+		t2 = t4 ;
+		int bestGain = g - cost(t1, t2) ;
+		size_t bestSize = moves.size() ;
+
+		for(int depth = 1 ; depth < LK_DEPTH ; depth++) {
+			int bestT3 = -1, bestT4 = -1, bestValue = 0 ;
+			for(size_t k = 0 ; k < neighbours[t2].size() ; k++) {
+				int c = neighbours[t2][k] ;
+				int g1 = g - cost(t2, c) ;
+				if(g1 <= 0)
+					break ;
+				if(c == t1 || c == tour.next(t2) || c == tour.prev(t2))
+					continue ;
+				int d = partner(t1, t2, c) ;
+				if(isAdded(c, d))
+					continue ;
+				if(bestT3 == -1 || g1 + cost(c, d) > bestValue) {
+					bestT3 = c ;
+					bestT4 = d ;
+					bestValue = g1 + cost(c, d) ;
+				}
+			}
+			if(bestT3 == -1)
+				break ;
+			apply(t1, t2, bestT3, bestT4) ;
+			g = bestValue ;
+			t2 = bestT4 ;
+			if(g - cost(t1, t2) > bestGain) {
+				bestGain = g - cost(t1, t2) ;
+				bestSize = moves.size() ;
+			}
+		}
+
+		if(bestGain <= 0)
+			bestSize = 0 ;
+		//undo the moves past the best prefix, latest first
+		while(moves.size() > bestSize) {
+			size_t k = moves.size() - 4 ;
+			int a = moves[k], b = moves[k + 1], d = moves[k + 3] ;
+			tour.move(a, d, b) ;
+			moves.resize(k) ;
+		}
+		for(size_t k = 0 ; k < moves.size() ; k++)
+			push(moves[k]) ;
+		return bestSize > 0 ;
+	}
+
+	bool improve(int t1) {
+		for(int dir = 0 ; dir < 2 ; dir++) {
+			int t2 = dir == 0 ? tour.next(t1) : tour.prev(t1) ;
+			int d12 = cost(t1, t2) ;
+			for(size_t k = 0 ; k < neighbours[t2].size() ; k++) {
+				int t3 = neighbours[t2][k] ;
+				if(cost(t2, t3) >= d12)
+					break ;
+				if(t3 == t1 || t3 == tour.next(t2) || t3 == tour.prev(t2))
+					continue ;
+				if(chain(t1, t2, t3))
+					return true ;
+			}
+		}
+		return false ;
+	}
+
+	void run() {
+		vector<int> start = tour.toVector() ;
+		for(size_t i = 0 ; i < start.size() ; i++)
+			push(start[i]) ;
+		while(!queue.empty()) {
+			int a = queue.front() ;
+			queue.pop_front() ;
+			queued[a] = 0 ;
+			if(improve(a))
+				push(a) ;
+		}
+	}
+} ;
+
+//random double-bridge: A B C D becomes A C B D
+void doubleBridge(vector<int>& tour, mt19937& rng) {
+	int n = tour.size() ;
+	int cut[3] ;
+	for(int k = 0 ; k < 3 ; k++)
+		cut[k] = 1 + rng() % (n - 1) ;
+	sort(cut, cut + 3) ;
+	if(cut[0] == cut[1] || cut[1] == cut[2])
+		return ;
+	rotate(tour.begin() + cut[0], tour.begin() + cut[1], tour.begin() + cut[2]) ;
+}
+
+vector<int> linKernighan(const DistanceMatrix& graph, int type, int restarts) {
+	int n = graph.size() ;
+	vector<int> start = minimumSpanningTree(graph) ;
+	if(n < LK_MIN_SIZE) {
+		improveTour(graph, start, type) ;
+		return start ;
+	}
+
+	vector<vector<int> > neighbours = nearestNeighbours(graph, LK_NEIGHBOURS, type) ;
+	int threads = hardwareThreads() ;
+	if(restarts <= 0)
+		restarts = threads ;
+
+	//restart 0 improves the MST tour itself, the others a kicked copy of it
+	vector<vector<int> > tours (restarts) ;
+	vector<int> costs (restarts) ;
+	parallelFor(restarts, [&](int r, int) {
+		vector<int> tour = start ;
+		mt19937 rng (r) ;
+		if(r > 0)
+			for(int k = 0 ; k < 1 + n / 50 ; k++)
+				doubleBridge(tour, rng) ;
+		TwoLevelList list (tour) ;
+		LinKernighanSearch search (graph, type, list, neighbours) ;
+		search.run() ;
+		tours[r] = list.toVector() ;
+		costs[r] = poids(graph, tours[r], type) ;
+	}, threads) ;
+
+	int best = 0 ;
+	for(int r = 1 ; r < restarts ; r++)
+		if(costs[r] < costs[best])
+			best = r ;
+	return tours[best] ;
+}
@@ -0,0 +1,214 @@
+//2-opt and Or-opt local search
+//The tour is kept as an array with the position of every vertex, moves are
+//only tried towards the NEIGHBOURS nearest vertices of each endpoint and a
+//vertex is only looked at again once one of its tour edges has changed
+//(don't-look bits, the vertices to look at wait in a queue).
+
+#include "../include/Algorithmic.h"
+#include "../include/Parallel.h"
+#include <algorithm>
+#include <deque>
+
+#define NEIGHBOURS 8      //size of the candidate lists
+#define OR_OPT_LENGTH 3   //longest segment moved by Or-opt
+
+vector<vector<int> > nearestNeighbours(const DistanceMatrix& graph, int k, int type) {
+	int n = graph.size() ;
+	if(k > n - 1)
+		k = n - 1 ;
+	vector<vector<int> > res (n) ;
+	parallelFor(n, [&](int u, int) {
+		vector<int> others ;
+		for(int v = 0 ; v < n ; v++)
+			if(v != u)
+				others.push_back(v) ;
+		auto closer = [&](int a, int b) {
+			int ca = edgeCost(graph, u, a, type), cb = edgeCost(graph, u, b, type) ;
+			return ca != cb ? ca < cb : graph(u, a) < graph(u, b) ;
+		} ;
+		if(k < (int) others.size())
+			nth_element(others.begin(), others.begin() + k, others.end(), closer) ;
+		others.resize(k) ;
+		sort(others.begin(), others.end(), closer) ;
+		res[u] = others ;
+	}) ;
+	return res ;
+}
+
+TourArray::TourArray(const vector<int>& tour) : order(tour), pos(tour.size()) {
+	for(size_t i = 0 ; i < order.size() ; i++)
+		pos[order[i]] = i ;
+}
+
+//reverses the path from x to y, or the rest of the tour when it is shorter
+//(both give the same cycle)
+void TourArray::reversePath(int x, int y) {
+	int n = order.size() ;
+	int i = pos[x], j = pos[y] ;
+	int len = (j - i + n) % n + 1 ;
+	if(2 * len > n) {
+		i = (j + 1) % n ;
+		j = (pos[x] - 1 + n) % n ;
+		len = n - len ;
+	}
+	for(int k = 0 ; k < len / 2 ; k++) {
+		int a = order[i], b = order[j] ;
+		order[i] = b ;
+		pos[b] = i ;
+		order[j] = a ;
+		pos[a] = j ;
+		i = (i + 1) % n ;
+		j = (j - 1 + n) % n ;
+	}
+}
+
+//replaces the edges (a,b) and (c,d) by (a,c) and (b,d), where d follows c in
+//the direction b follows a: d is implied by a, b and c
+void TourArray::move(int a, int b, int c) {
+	if(next(a) == b)
+		reversePath(b, c) ;
+	else
+		reversePath(c, b) ;
+}
+
+struct LocalSearchState {
+	const DistanceMatrix& graph ;
+	int type ;
+	TourArray& tour ;
+	const vector<vector<int> >& neighbours ;
+	deque<int> queue ;
+	vector<char> queued ;
+
+	LocalSearchState(const DistanceMatrix& graph, int type, TourArray& tour, const vector<vector<int> >& neighbours) :
+		graph(graph), type(type), tour(tour), neighbours(neighbours), queued(tour.size(), 0) {}
+
+	inline int cost(int u, int v) const { return edgeCost(graph, u, v, type) ; }
+	inline int step(int v, int dir) const { return dir == 0 ? tour.next(v) : tour.prev(v) ; }
+
+	void push(int v) {
+		if(!queued[v]) {
+			queued[v] = 1 ;
+			queue.push_back(v) ;
+		}
+	}
+
+	//best 2-opt move removing one of the tour edges of a
+	bool twoOpt(int a) {
+		for(int dir = 0 ; dir < 2 ; dir++) {
+			int b = step(a, dir) ;
+			int dab = cost(a, b) ;
+			for(size_t k = 0 ; k < neighbours[a].size() ; k++) {
+				int c = neighbours[a][k] ;
+				int dac = cost(a, c) ;
+				if(dac >= dab)
+					break ;
+				int d = step(c, dir) ;
+				if(c == b || d == a)
+					continue ;
+				if(dac + cost(b, d) < dab + cost(c, d)) {
+					tour.move(a, b, c) ;
+					push(a) ;
+					push(b) ;
+					push(c) ;
+					push(d) ;
+					return true ;
+				}
+			}
+		}
+		return false ;
+	}
+
+	//moves a segment of 1 to OR_OPT_LENGTH vertices starting at a between two
+	//vertices close to one of its ends, possibly reversed
+	bool orOpt(int a) {
+		int n = tour.size() ;
+		for(int dir = 0 ; dir < 2 ; dir++) {
+			int s1 = a, se = a ;
+			for(int len = 1 ; len <= OR_OPT_LENGTH && len <= n - 5 ; len++) {
+				if(len > 1)
+					se = step(se, dir) ;
+				int p = step(s1, 1 - dir), nx = step(se, dir) ;
+				int removeGain = cost(p, s1) + cost(se, nx) - cost(p, nx) ;
+				if(removeGain <= 0)
+					continue ;
+
+				for(int end = 0 ; end < 2 ; end++) {
+					int e = end == 0 ? s1 : se ;
+					for(size_t k = 0 ; k < neighbours[e].size() ; k++) {
+						int c = neighbours[e][k] ;
+						if(cost(e, c) >= removeGain)
+							break ;
+						//the insertion edge (x, y), y following x
+						for(int side = 0 ; side < 2 ; side++) {
+							int x = side == 0 ? c : step(c, 1 - dir) ;
+							int y = step(x, dir) ;
+							if(inSegment(x, s1, len, dir) || inSegment(y, s1, len, dir) || x == p || y == p || x == nx || y == nx)
+								continue ;
+							int straight = cost(x, s1) + cost(se, y) ;
+							int reversed = cost(x, se) + cost(s1, y) ;
+							int add = min(straight, reversed) - cost(x, y) ;
+							if(add < removeGain) {
+								tour.move(p, s1, x) ;
+								tour.move(p, x, nx) ;
+								if(straight < reversed)
+									tour.move(x, se, s1) ;
+								push(p) ;
+								push(nx) ;
+								push(s1) ;
+								push(se) ;
+								push(x) ;
+								push(y) ;
+								return true ;
+							}
+						}
+					}
+				}
+			}
+		}
+		return false ;
+	}
+
+	bool inSegment(int v, int s1, int len, int dir) const {
+		for(int k = 0 ; k < len ; k++) {
+			if(v == s1)
+				return true ;
+			s1 = step(s1, dir) ;
+		}
+		return false ;
+	}
+
+	void run() {
+		for(int i = 0 ; i < tour.size() ; i++)
+			push(tour.at(i)) ;
+		while(!queue.empty()) {
+			int a = queue.front() ;
+			queue.pop_front() ;
+			queued[a] = 0 ;
+			if(twoOpt(a) || orOpt(a))
+				push(a) ;
+		}
+	}
+} ;
+
+void improveTour(const DistanceMatrix& graph, TourArray& tour, const vector<vector<int> >& neighbours, int type) {
+	if(tour.size() < 5)
+		return ;
+	LocalSearchState state (graph, type, tour, neighbours) ;
+	state.run() ;
+}
+
+int improveTour(const DistanceMatrix& graph, vector<int>& tour, int type) {
+	if(tour.size() >= 5) {
+		TourArray array (tour) ;
+		improveTour(graph, array, nearestNeighbours(graph, NEIGHBOURS, type), type) ;
+		for(int i = 0 ; i < array.size() ; i++)
+			tour[i] = array.at(i) ;
+	}
+	return poids(graph, tour, type) ;
+}
+
+vector<int> warmStart(const DistanceMatrix& graph, int type) {
+	vector<int> tour = minimumSpanningTree(graph) ;
+	improveTour(graph, tour, type) ;
+	return tour ;
+}
@@ -0,0 +1,42 @@
+#include "../include/Parallel.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+int hardwareThreads() {
+#if defined(__linux__)
+	//a process pinned to some cores only uses those
+	cpu_set_t allowed ;
+	if(sched_getaffinity(0, sizeof(allowed), &allowed) == 0 && CPU_COUNT(&allowed) > 0)
+		return CPU_COUNT(&allowed) ;
+#endif
+	unsigned int n = std::thread::hardware_concurrency() ;
+	return n == 0 ? 1 : (int) n ;
+}
+
+void parallelFor(int count, const std::function<void(int, int)>& body, int threads) {
+	if(threads <= 0)
+		threads = hardwareThreads() ;
+	if(threads > count)
+		threads = count ;
+	if(threads <= 1) {
+		for(int task = 0 ; task < count ; task++)
+			body(task, 0) ;
+		return ;
+	}
+
+	std::atomic<int> next (0) ;
+	std::vector<std::thread> workers ;
+	for(int w = 0 ; w < threads ; w++) {
+		workers.push_back(std::thread([&, w]() {
+			int task ;
+			while((task = next.fetch_add(1)) < count)
+				body(task, w) ;
+		})) ;
+	}
+	for(int w = 0 ; w < threads ; w++)
+		workers[w].join() ;
+}
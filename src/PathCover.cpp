@@ -0,0 +1,154 @@
+//Path covers for the DISCRETE mode
+//The edges only cost 0 (graph edge) or 1 (non-edge): a tour with k >= 1
+//heavy edges is a cover of the vertices by k paths of graph edges, so the
+//problem is to cover the graph with as few paths as possible, or to find a
+//Hamiltonian cycle. Both engines work on the bitset adjacency, the exact one
+//with the subset kernels of HamiltonianCycle.cpp.
+
+#include "../include/Algorithmic.h"
+#include "../include/BitGraph.h"
+#include <algorithm>
+#include <climits>
+#include <iostream>
+
+#define POSA_ROTATIONS 50 //rotations tried before a path is given up
+
+//greedy paths, extended towards the free vertex with the fewest free
+//neighbours. When both ends are stuck, Pósa rotations (the end e has a
+//neighbour w on the path, the part after w is reversed and the successor of
+//w becomes the end) look for an end which can still be extended.
+struct GreedyPathCover {
+	const BitGraph& g ;
+	vector<uint64_t> free ;   //vertices in no path yet
+	vector<uint64_t> onPath ; //vertices of the current path
+	vector<int> path ;
+	vector<int> pos ;
+
+	GreedyPathCover(const BitGraph& g) : g(g), free(g.words(), 0), onPath(g.words(), 0), pos(g.size(), 0) {
+		for(int v = 0 ; v < g.size() ; v++)
+			free[v / 64] |= (uint64_t) 1 << (v % 64) ;
+	}
+
+	void add(int v) {
+		free[v / 64] &= ~((uint64_t) 1 << (v % 64)) ;
+		onPath[v / 64] |= (uint64_t) 1 << (v % 64) ;
+		pos[v] = path.size() ;
+		path.push_back(v) ;
+	}
+
+	void reverse(int i, int j) {
+		for( ; i < j ; i++, j--) {
+			swap(path[i], path[j]) ;
+			pos[path[i]] = i ;
+			pos[path[j]] = j ;
+		}
+	}
+
+	//free neighbour of v with the fewest free neighbours, -1 if there is none
+	int extension(int v) const {
+		const uint64_t* r = g.row(v) ;
+		int best = -1, bestDegree = INT_MAX ;
+		for(int w = 0 ; w < g.words() ; w++) {
+			for(uint64_t m = r[w] & free[w] ; m ; m &= m - 1) {
+				int u = w * 64 + __builtin_ctzll(m) ;
+				int d = g.degree(u, free.data()) ;
+				if(d < bestDegree) {
+					best = u ;
+					bestDegree = d ;
+				}
+			}
+		}
+		return best ;
+	}
+
+	//rotates the end of the path until it has a free neighbour or, with
+	//close, until it is adjacent to the start of the path
+	bool rotate(bool close) {
+		for(int r = 0 ; r < POSA_ROTATIONS ; r++) {
+			int len = path.size() ;
+			const uint64_t* e = g.row(path.back()) ;
+			vector<int> pivots ;
+			for(int w = 0 ; w < g.words() ; w++) {
+				for(uint64_t m = e[w] & onPath[w] ; m ; m &= m - 1) {
+					int i = pos[w * 64 + __builtin_ctzll(m)] ;
+					if(i >= len - 2)
+						continue ;
+					int c = path[i + 1] ;
+					if(close ? g.edge(c, path[0]) : g.degree(c, free.data()) > 0) {
+						reverse(i + 1, len - 1) ;
+						return true ;
+					}
+					pivots.push_back(i) ;
+				}
+			}
+			if(pivots.empty())
+				return false ;
+			reverse(pivots[r % pivots.size()] + 1, len - 1) ;
+		}
+		return false ;
+	}
+
+	vector<int> run() {
+		int n = g.size() ;
+		vector<int> tour ;
+		while((int) tour.size() < n) {
+			for(size_t i = 0 ; i < path.size() ; i++)
+				onPath[path[i] / 64] &= ~((uint64_t) 1 << (path[i] % 64)) ;
+			path.clear() ;
+
+			int start = -1, startDegree = INT_MAX ;
+			for(int v = 0 ; v < n ; v++) {
+				if((free[v / 64] >> (v % 64)) & 1) {
+					int d = g.degree(v, free.data()) ;
+					if(d < startDegree) {
+						start = v ;
+						startDegree = d ;
+					}
+				}
+			}
+			add(start) ;
+
+			for(;;) {
+				int next = extension(path.back()) ;
+				if(next < 0 && path.size() > 1) {
+					reverse(0, path.size() - 1) ;
+					next = extension(path.back()) ;
+				}
+				if(next < 0 && rotate(false))
+					next = extension(path.back()) ;
+				if(next < 0)
+					break ;
+				add(next) ;
+			}
+
+			//a single path through every vertex: we try to close it
+			if(tour.empty() && (int) path.size() == n && n > 2 && !g.edge(path.back(), path[0]))
+				rotate(true) ;
+			tour.insert(tour.end(), path.begin(), path.end()) ;
+		}
+		return tour ;
+	}
+} ;
+
+vector<int> pathCover(const DistanceMatrix& graph, bool exact) {
+	int n = graph.size() ;
+	if(n <= 3) {
+		vector<int> tour (n) ;
+		for(int i = 0 ; i < n ; i++)
+			tour[i] = i ;
+		return tour ;
+	}
+	//the greedy search is not a substitute, its covers are not minimum
+	if(exact && n > PATHCOVER_EXACT_MAX) {
+		cerr << "pathCover: " << n << " vertices, at most " << PATHCOVER_EXACT_MAX << " are covered exactly" << endl ;
+		return vector<int>() ;
+	}
+	BitGraph g (graph) ;
+	//exact: no heavy edge when there is a Hamiltonian cycle, otherwise one
+	//per path of a minimum cover
+	vector<int> tour ;
+	if(exact)
+		return hamiltonianCycle(g, tour) ? tour : minimumPathCover(g) ;
+	GreedyPathCover search (g) ;
+	return search.run() ;
+}
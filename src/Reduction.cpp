@@ -0,0 +1,294 @@
+//Reductions of the DISCRETE instances
+//A tour with k >= 1 heavy edges is a cover of the graph by k paths of graph
+//edges. The rules keep the size of the smallest cover, and whether there is
+//a Hamiltonian cycle, up to the vertices taken out in baseCost:
+// - a vertex u with r > 2 neighbours of degree 1: at most two of them are in
+//   the path through u, the others are paths on their own, whichever they are;
+// - isolated vertices are paths on their own, one of them is kept so that
+//   the reduced graph stays without Hamiltonian cycle;
+// - a path v1..vk of vertices of degree 2 between u and w is covered as well
+//   by a single vertex joined to u and w, any cover cutting it can follow it
+//   instead without more paths.
+//The reduced graph always keeps at least 3 vertices.
+
+#include "../include/Reduction.h"
+#include "../include/Algorithmic.h"
+#include <algorithm>
+#include <deque>
+
+//removes v from the neighbours of u
+void unlink(vector<vector<int> >& adj, int u, int v) {
+	adj[u].erase(find(adj[u].begin(), adj[u].end(), v)) ;
+}
+
+//depth-first search numbering: split[u] counts the children of u which are
+//cut from the rest of the component when u is removed
+struct CutVertices {
+	const vector<vector<int> >& adj ;
+	vector<int> order, low, split ;
+	int time ;
+
+	CutVertices(const vector<vector<int> >& adj) : adj(adj), order(adj.size(), -1), low(adj.size(), 0), split(adj.size(), 0), time(0) {}
+
+	void visit(int u, int parent) {
+		order[u] = low[u] = time++ ;
+		for(size_t i = 0 ; i < adj[u].size() ; i++) {
+			int v = adj[u][i] ;
+			if(order[v] < 0) {
+				visit(v, u) ;
+				low[u] = min(low[u], low[v]) ;
+				if(low[v] >= order[u])
+					split[u]++ ;
+			}
+			else if(v != parent)
+				low[u] = min(low[u], order[v]) ;
+		}
+	}
+} ;
+
+//every path has at most two ends of degree 1 and a vertex of degree 0 is a
+//path, every component needs its own path, and a path through a cut vertex c
+//joins at most two of the components of G - c
+int reducedLowerBound(const vector<vector<int> >& adj) {
+	int n = adj.size() ;
+	int isolated = 0, leaves = 0 ;
+	for(int v = 0 ; v < n ; v++) {
+		if(adj[v].empty())
+			isolated++ ;
+		else if(adj[v].size() == 1)
+			leaves++ ;
+	}
+
+	CutVertices cut (adj) ;
+	vector<char> root (n, 0) ;
+	int components = 0 ;
+	for(int v = 0 ; v < n ; v++) {
+		if(cut.order[v] < 0) {
+			components++ ;
+			root[v] = 1 ;
+			cut.visit(v, -1) ;
+		}
+	}
+
+	int res = max(isolated + (leaves + 1) / 2, components > 1 ? components : 0) ;
+	bool hamiltonian = components == 1 && isolated + leaves == 0 ;
+	for(int c = 0 ; c < n ; c++) {
+		int pieces = components - 1 + cut.split[c] + (root[c] ? 0 : 1) ;
+		res = max(res, pieces - 1) ;
+		if(pieces > components)
+			hamiltonian = false ;
+	}
+	if(!hamiltonian)
+		res = max(res, 1) ;
+	return res ;
+}
+
+//orients the paths of consecutive vertices so that each one starts next to
+//the end of the previous one, or ends next to the following one, the ends of
+//a path have a single neighbour outside of it
+vector<int> joinPaths(const DistanceMatrix& graph, const vector<const vector<int>*>& paths) {
+	vector<int> res ;
+	for(size_t i = 0 ; i < paths.size() ; i++) {
+		const vector<int>& path = *paths[i] ;
+		bool forward ;
+		if(!res.empty() && graph(res.back(), path.front()) != 10)
+			forward = true ;
+		else if(!res.empty() && graph(res.back(), path.back()) != 10)
+			forward = false ;
+		else if(i + 1 < paths.size())
+			forward = graph(path.back(), paths[i + 1]->front()) != 10 || graph(path.back(), paths[i + 1]->back()) != 10 ;
+		else
+			forward = true ;
+		if(forward)
+			res.insert(res.end(), path.begin(), path.end()) ;
+		else
+			res.insert(res.end(), path.rbegin(), path.rend()) ;
+	}
+	return res ;
+}
+
+//one application of the three rules on the current graph, whose vertices
+//stand for the paths of original vertices in members
+void reducePass(const DistanceMatrix& graph, vector<vector<int> >& adj, vector<vector<int> >& members, vector<vector<int> >& removed) {
+	int n = adj.size() ;
+	vector<char> alive (n, 1) ;
+	int size = n ;
+
+	for(int u = 0 ; u < n ; u++) {
+		vector<int> leaves ;
+		for(size_t i = 0 ; i < adj[u].size() ; i++)
+			if(adj[adj[u][i]].size() == 1)
+				leaves.push_back(adj[u][i]) ;
+		for(size_t i = 2 ; i < leaves.size() && size > 3 ; i++) {
+			unlink(adj, u, leaves[i]) ;
+			adj[leaves[i]].clear() ;
+			alive[leaves[i]] = 0 ;
+			removed.push_back(members[leaves[i]]) ;
+			size-- ;
+		}
+	}
+
+	bool kept = false ;
+	for(int v = 0 ; v < n && size > 3 ; v++) {
+		if(!alive[v] || !adj[v].empty())
+			continue ;
+		if(kept) {
+			alive[v] = 0 ;
+			removed.push_back(members[v]) ;
+			size-- ;
+		}
+		kept = true ;
+	}
+
+	//paths of vertices of degree 2, walked from each end
+	vector<int> chain (n, -1) ;
+	vector<vector<int> > chains ;
+	vector<pair<int, int> > ends ;
+	vector<char> seen (n, 0) ;
+	for(int v = 0 ; v < n ; v++) {
+		if(!alive[v] || adj[v].size() != 2 || seen[v])
+			continue ;
+		deque<int> run (1, v) ;
+		seen[v] = 1 ;
+		int from = v, cur = adj[v][0] ;
+		while(adj[cur].size() == 2 && cur != v) {
+			seen[cur] = 1 ;
+			run.push_back(cur) ;
+			int next = adj[cur][0] == from ? adj[cur][1] : adj[cur][0] ;
+			from = cur ;
+			cur = next ;
+		}
+		int first, last = cur ;
+		if(cur == v) {
+			//a whole component is a cycle, it becomes a triangle
+			if(run.size() <= 3)
+				continue ;
+			first = run.back() ;
+			run.pop_back() ;
+			last = run.back() ;
+			run.pop_back() ;
+		}
+		else {
+			from = v ;
+			cur = adj[v][1] ;
+			while(adj[cur].size() == 2) {
+				seen[cur] = 1 ;
+				run.push_front(cur) ;
+				int next = adj[cur][0] == from ? adj[cur][1] : adj[cur][0] ;
+				from = cur ;
+				cur = next ;
+			}
+			first = cur ;
+		}
+		if(run.size() < 2)
+			continue ;
+		for(size_t i = 0 ; i < run.size() ; i++)
+			chain[run[i]] = chains.size() ;
+		chains.push_back(vector<int>(run.begin(), run.end())) ;
+		ends.push_back(make_pair(first, last)) ;
+	}
+
+	vector<int> index (n, -1) ;
+	vector<vector<int> > reducedMembers ;
+	for(int v = 0 ; v < n ; v++) {
+		if(!alive[v] || (chain[v] >= 0 && chains[chain[v]][0] != v))
+			continue ;
+		index[v] = reducedMembers.size() ;
+		if(chain[v] < 0)
+			reducedMembers.push_back(members[v]) ;
+		else {
+			const vector<int>& run = chains[chain[v]] ;
+			vector<const vector<int>*> paths ;
+			for(size_t i = 0 ; i < run.size() ; i++)
+				paths.push_back(&members[run[i]]) ;
+			reducedMembers.push_back(joinPaths(graph, paths)) ;
+		}
+	}
+
+	vector<vector<int> > reduced (reducedMembers.size()) ;
+	auto link = [&](int x, int y) {
+		if(find(reduced[x].begin(), reduced[x].end(), y) == reduced[x].end()) {
+			reduced[x].push_back(y) ;
+			reduced[y].push_back(x) ;
+		}
+	} ;
+	for(int u = 0 ; u < n ; u++)
+		if(alive[u] && chain[u] < 0)
+			for(size_t i = 0 ; i < adj[u].size() ; i++)
+				if(chain[adj[u][i]] < 0 && u < adj[u][i])
+					link(index[u], index[adj[u][i]]) ;
+	for(size_t c = 0 ; c < chains.size() ; c++) {
+		link(index[chains[c][0]], index[ends[c].first]) ;
+		link(index[chains[c][0]], index[ends[c].second]) ;
+	}
+	adj.swap(reduced) ;
+	members.swap(reducedMembers) ;
+}
+
+GraphReduction reduceGraph(const DistanceMatrix& graph) {
+	int n = graph.size() ;
+	vector<vector<int> > adj (n), members (n), removed ;
+	for(int u = 0 ; u < n ; u++) {
+		members[u].assign(1, u) ;
+		for(int v = 0 ; v < n ; v++)
+			if(u != v && graph(u, v) != 10)
+				adj[u].push_back(v) ;
+	}
+	//a compressed path may give a vertex its third neighbour of degree 1
+	if(n >= 3) {
+		size_t size ;
+		do {
+			size = adj.size() ;
+			reducePass(graph, adj, members, removed) ;
+		} while(adj.size() < size) ;
+	}
+
+	GraphReduction res ;
+	int m = adj.size() ;
+	res.graph = DistanceMatrix(m, WIDTH8, 10) ;
+	for(int x = 0 ; x < m ; x++) {
+		res.graph.set(x, x, 0) ;
+		for(size_t i = 0 ; i < adj[x].size() ; i++)
+			res.graph.set(x, adj[x][i], 1) ;
+	}
+	res.members = members ;
+	res.removed = removed ;
+	res.baseCost = removed.size() ;
+	res.lowerBound = n < 3 ? 0 : res.baseCost + reducedLowerBound(adj) ;
+	return res ;
+}
+
+vector<int> expandTour(const DistanceMatrix& graph, const GraphReduction& reduction, const vector<int>& tour) {
+	int m = tour.size() ;
+	//the expansion starts after a heavy edge, or at a single vertex when there
+	//is none, so that the first path is only constrained by the next one
+	int start = -1 ;
+	for(int i = 0 ; i < m && start < 0 ; i++)
+		if(reduction.graph(tour[i], tour[(i + 1) % m]) == 10)
+			start = (i + 1) % m ;
+	for(int i = 0 ; i < m && start < 0 ; i++)
+		if(reduction.members[tour[i]].size() == 1)
+			start = i ;
+	if(start < 0)
+		start = 0 ;
+
+	vector<const vector<int>*> paths ;
+	for(int i = 0 ; i < m ; i++)
+		paths.push_back(&reduction.members[tour[(start + i) % m]]) ;
+	vector<int> res = joinPaths(graph, paths) ;
+
+	//the paths taken out go in a heavy edge, one more heavy edge each
+	int size = res.size() ;
+	int at = size - 1 ;
+	for(int i = 0 ; i < size - 1 ; i++) {
+		if(graph(res[i], res[i + 1]) == 10) {
+			at = i ;
+			break ;
+		}
+	}
+	for(size_t i = 0 ; i < reduction.removed.size() ; i++) {
+		res.insert(res.begin() + at + 1, reduction.removed[i].begin(), reduction.removed[i].end()) ;
+		at += reduction.removed[i].size() ;
+	}
+	return res ;
+}
@@ -0,0 +1,276 @@
+//Benchmark results store
+//Every timed trial is one line, appended to the file: results of several
+//runs, and of several builds, accumulate and can be compared later. A CSV
+//file starts with the names of its columns; a .jsonl file has one flat
+//object per line with the same names.
+
+#include "../include/Results.h"
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <tuple>
+#include <algorithm>
+
+static const char* COLUMNS[] = { "build", "mode", "algorithm", "n", "density", "weight", "seed", "repetition", "status", "wall", "cpu", "max_rss_kb", "cost", "generator" } ;
+#define NB_COLUMNS (sizeof(COLUMNS) / sizeof(COLUMNS[0]))
+
+static bool isJsonLines(const char* fileName) {
+	string name (fileName) ;
+	return name.size() >= 6 && name.compare(name.size() - 6, 6, ".jsonl") == 0 ;
+}
+
+//value of the column, strings are not quoted
+static string field(const ResultRecord& r, size_t column) {
+	ostringstream os ;
+	os << setprecision(9) ;
+	switch(column) {
+	case 0 : os << r.build ; break ;
+	case 1 : os << r.mode ; break ;
+	case 2 : os << r.algorithm ; break ;
+	case 3 : os << r.n ; break ;
+	case 4 : os << r.density ; break ;
+	case 5 : os << r.weight ; break ;
+	case 6 : os << r.seed ; break ;
+	case 7 : os << r.repetition ; break ;
+	case 8 : os << r.status ; break ;
+	case 9 : os << r.wall ; break ;
+	case 10 : os << r.cpu ; break ;
+	case 11 : os << r.maxRss ; break ;
+	case 12 : os << r.cost ; break ;
+	default : os << r.generator ; break ;
+	}
+	return os.str() ;
+}
+
+static bool isText(size_t column) {
+	return column <= 2 || column == 8 || column == 13 ;
+}
+
+static void setField(ResultRecord& r, const string& name, const string& value) {
+	if(name == "build") r.build = value ;
+	else if(name == "mode") r.mode = value ;
+	else if(name == "algorithm") r.algorithm = value ;
+	else if(name == "n") r.n = atoi(value.c_str()) ;
+	else if(name == "density") r.density = atof(value.c_str()) ;
+	else if(name == "weight") r.weight = atoi(value.c_str()) ;
+	else if(name == "seed") r.seed = atoll(value.c_str()) ;
+	else if(name == "repetition") r.repetition = atoi(value.c_str()) ;
+	else if(name == "status") r.status = value ;
+	else if(name == "wall") r.wall = atof(value.c_str()) ;
+	else if(name == "cpu") r.cpu = atof(value.c_str()) ;
+	else if(name == "max_rss_kb") r.maxRss = atol(value.c_str()) ;
+	else if(name == "cost") r.cost = atoi(value.c_str()) ;
+	else if(name == "generator") r.generator = value ;
+}
+
+static ResultRecord emptyRecord() {
+	ResultRecord r ;
+	r.n = r.weight = r.repetition = r.cost = 0 ;
+	r.density = r.wall = r.cpu = 0 ;
+	r.seed = -1 ;
+	r.maxRss = 0 ;
+	return r ;
+}
+
+bool appendResults(const char* fileName, const vector<ResultRecord>& records) {
+	bool json = isJsonLines(fileName) ;
+	bool empty ;
+	{
+		ifstream is (fileName) ;
+		empty = !is || is.peek() == ifstream::traits_type::eof() ;
+	}
+	ofstream os (fileName, ios::app) ;
+	if(!os) {
+		cerr << fileName << ": cannot be written" << endl ;
+		return false ;
+	}
+	if(empty && !json) {
+		for(size_t c = 0 ; c < NB_COLUMNS ; c++)
+			os << (c ? "," : "") << COLUMNS[c] ;
+		os << "\n" ;
+	}
+	for(size_t i = 0 ; i < records.size() ; i++) {
+		for(size_t c = 0 ; c < NB_COLUMNS ; c++) {
+			string value = field(records[i], c) ;
+			if(!json)
+				os << (c ? "," : "") << value ;
+			else if(isText(c))
+				os << (c ? ", \"" : "{\"") << COLUMNS[c] << "\": \"" << value << "\"" ;
+			else
+				os << ", \"" << COLUMNS[c] << "\": " << value ;
+		}
+		os << (json ? "}\n" : "\n") ;
+	}
+	os.flush() ;
+	return (bool) os ;
+}
+
+//"key": value pairs of a flat object, the values are strings or numbers
+static ResultRecord parseJsonLine(const string& line) {
+	ResultRecord r = emptyRecord() ;
+	size_t i = 0 ;
+	while((i = line.find('"', i)) != string::npos) {
+		size_t end = line.find('"', i + 1) ;
+		size_t colon = line.find(':', end) ;
+		if(end == string::npos || colon == string::npos)
+			break ;
+		string key = line.substr(i + 1, end - i - 1) ;
+		size_t start = line.find_first_not_of(" \t", colon + 1) ;
+		if(start == string::npos)
+			break ;
+		if(line[start] == '"') {
+			end = line.find('"', start + 1) ;
+			setField(r, key, line.substr(start + 1, end - start - 1)) ;
+			i = end + 1 ;
+		}
+		else {
+			end = line.find_first_of(",}", start) ;
+			setField(r, key, line.substr(start, end - start)) ;
+			i = end ;
+		}
+		if(end == string::npos)
+			break ;
+	}
+	return r ;
+}
+
+bool readResults(const char* fileName, vector<ResultRecord>& records) {
+	ifstream is (fileName) ;
+	if(!is) {
+		cerr << fileName << ": cannot be read" << endl ;
+		return false ;
+	}
+	bool json = isJsonLines(fileName) ;
+	vector<string> header ;
+	string line ;
+	while(getline(is, line)) {
+		if(!line.empty() && line[line.size() - 1] == '\r')
+			line.erase(line.size() - 1) ;
+		if(line.empty())
+			continue ;
+		if(json) {
+			records.push_back(parseJsonLine(line)) ;
+			continue ;
+		}
+		vector<string> values ;
+		stringstream ss (line) ;
+		string value ;
+		while(getline(ss, value, ','))
+			values.push_back(value) ;
+		if(header.empty()) {
+			header = values ;
+			continue ;
+		}
+		ResultRecord r = emptyRecord() ;
+		for(size_t c = 0 ; c < values.size() && c < header.size() ; c++)
+			setField(r, header[c], values[c]) ;
+		records.push_back(r) ;
+	}
+	return true ;
+}
+
+struct Group {
+	vector<double> base, candidate ;
+	int baseTimeouts, candidateTimeouts ;
+	Group() : baseTimeouts(0), candidateTimeouts(0) {}
+} ;
+
+typedef tuple<string, string, string, int, double, int> GroupKey ;
+
+static double median(vector<double> values) {
+	sort(values.begin(), values.end()) ;
+	size_t m = values.size() / 2 ;
+	return values.size() % 2 ? values[m] : (values[m - 1] + values[m]) / 2 ;
+}
+
+//one-sided p-value of the Mann-Whitney U test for "y tends to be larger
+//than x": normal approximation with tie correction and continuity correction
+static double mannWhitney(const vector<double>& x, const vector<double>& y) {
+	vector<pair<double, int> > all ;
+	for(size_t i = 0 ; i < x.size() ; i++)
+		all.push_back(make_pair(x[i], 0)) ;
+	for(size_t i = 0 ; i < y.size() ; i++)
+		all.push_back(make_pair(y[i], 1)) ;
+	sort(all.begin(), all.end()) ;
+
+	double rankSum = 0, ties = 0 ;
+	size_t total = all.size() ;
+	for(size_t i = 0 ; i < total ; ) {
+		size_t j = i ;
+		while(j < total && all[j].first == all[i].first)
+			j++ ;
+		double rank = (i + 1 + j) / 2.0 ;
+		for(size_t k = i ; k < j ; k++)
+			if(all[k].second == 1)
+				rankSum += rank ;
+		double t = j - i ;
+		ties += t * t * t - t ;
+		i = j ;
+	}
+
+	double m = y.size(), k = x.size(), N = total ;
+	double u = rankSum - m * (m + 1) / 2 ;
+	double variance = m * k / 12 * ((N + 1) - ties / (N * (N - 1))) ;
+	if(variance <= 0)
+		return 1 ;
+	double z = (u - m * k / 2 - 0.5) / sqrt(variance) ;
+	return 0.5 * erfc(z / sqrt(2.0)) ;
+}
+
+int compareResults(const char* base, const char* candidate, double alpha) {
+	vector<ResultRecord> baseRecords, candidateRecords ;
+	if(!readResults(base, baseRecords) || !readResults(candidate, candidateRecords))
+		return -1 ;
+
+	map<GroupKey, Group> groups ;
+	for(int side = 0 ; side < 2 ; side++) {
+		const vector<ResultRecord>& records = side ? candidateRecords : baseRecords ;
+		for(size_t i = 0 ; i < records.size() ; i++) {
+			const ResultRecord& r = records[i] ;
+			Group& g = groups[GroupKey(r.mode, r.generator, r.algorithm, r.n, r.density, r.weight)] ;
+			if(r.status == "ok")
+				(side ? g.candidate : g.base).push_back(r.wall) ;
+			else if(r.status == "timeout")
+				(side ? g.candidateTimeouts : g.baseTimeouts)++ ;
+		}
+	}
+
+	int regressions = 0 ;
+	cout << "# mode generator algorithm n density weight base_median candidate_median ratio p verdict" << endl ;
+	for(map<GroupKey, Group>::const_iterator it = groups.begin() ; it != groups.end() ; ++it) {
+		const Group& g = it->second ;
+		bool inBase = !g.base.empty() || g.baseTimeouts > 0 ;
+		bool inCandidate = !g.candidate.empty() || g.candidateTimeouts > 0 ;
+		if(!inBase || !inCandidate)
+			continue ;
+		cout << get<0>(it->first) << " " << get<1>(it->first) << " " << get<2>(it->first) << " " << get<3>(it->first) << " " << get<4>(it->first) << " " << get<5>(it->first) << " " ;
+
+		if(g.base.empty() || g.candidate.empty()) {
+			//only timeouts on one side at least
+			bool worse = g.candidate.empty() && !g.base.empty() ;
+			cout << "- - - - " << (worse ? "timeouts" : g.candidate.empty() ? "same" : "faster") << endl ;
+			regressions += worse ;
+			continue ;
+		}
+		double baseMedian = median(g.base), candidateMedian = median(g.candidate) ;
+		double ratio = baseMedian > 0 ? candidateMedian / baseMedian : 1 ;
+		double slower = mannWhitney(g.base, g.candidate) ;
+		double faster = mannWhitney(g.candidate, g.base) ;
+		string verdict = "same" ;
+		if(slower < alpha && ratio >= COMPARE_MIN_RATIO)
+			verdict = "slower" ;
+		else if(faster < alpha && ratio <= 1 / COMPARE_MIN_RATIO)
+			verdict = "faster" ;
+		if(verdict != "slower" && g.candidateTimeouts > 0 && g.baseTimeouts == 0)
+			verdict = "timeouts" ;
+		if(verdict == "slower" || verdict == "timeouts")
+			regressions++ ;
+		cout << baseMedian << " " << candidateMedian << " " << ratio << " " << min(slower, faster) << " " << verdict << endl ;
+	}
+	cout << regressions << " regression(s)" << endl ;
+	return regressions ;
+}
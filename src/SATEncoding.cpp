@@ -0,0 +1,390 @@
+//CNF encodings of the Hamiltonian cycle problem
+//The encoders hand their clauses to a ClauseSink, which either writes them
+//as DIMACS text or loads them straight into a solver.
+
+#include "../include/SATEncoding.h"
+#include "../include/Algorithmic.h"
+
+//clauses of the sequential counter of sequentialCounter()
+long sequentialCounterClauses(int size, int k) {
+	if(size <= k)
+		return 0 ;
+	return k + (long) (size - 2) * (2 * k + 1) + 1 ;
+}
+
+//at most k of the literals are true (Sinz' sequential counter), s_i,j is
+//true when at least j of the first i literals are
+void sequentialCounter(const vector<int>& lits, int k, int& nextVar, ClauseSink& sink) {
+	int size = lits.size() ;
+	if(size <= k)
+		return ;
+	vector<int> prev (k), cur (k), clause ;
+	for(int j = 0 ; j < k ; j++)
+		prev[j] = nextVar++ ;
+	clause.assign({-lits[0], prev[0]}) ;
+	sink.addClause(clause) ;
+	for(int j = 1 ; j < k ; j++) {
+		clause.assign(1, -prev[j]) ;
+		sink.addClause(clause) ;
+	}
+	for(int i = 1 ; i < size - 1 ; i++) {
+		for(int j = 0 ; j < k ; j++)
+			cur[j] = nextVar++ ;
+		clause.assign({-lits[i], cur[0]}) ;
+		sink.addClause(clause) ;
+		clause.assign({-prev[0], cur[0]}) ;
+		sink.addClause(clause) ;
+		for(int j = 1 ; j < k ; j++) {
+			clause.assign({-lits[i], -prev[j - 1], cur[j]}) ;
+			sink.addClause(clause) ;
+			clause.assign({-prev[j], cur[j]}) ;
+			sink.addClause(clause) ;
+		}
+		clause.assign({-lits[i], -prev[k - 1]}) ;
+		sink.addClause(clause) ;
+		prev.swap(cur) ;
+	}
+	clause.assign({-lits[size - 1], -prev[k - 1]}) ;
+	sink.addClause(clause) ;
+}
+
+//variables and clauses of the totalizer of totalizer()
+void totalizerSize(int size, int& nbVar, long& nbClauses) {
+	if(size <= 1)
+		return ;
+	int left = size / 2, right = size - left ;
+	totalizerSize(left, nbVar, nbClauses) ;
+	totalizerSize(right, nbVar, nbClauses) ;
+	nbVar += size ;
+	nbClauses += left + right + (long) left * right ;
+}
+
+//unary counter of the literals: the j-th output is true when at least j+1
+//literals are (only this direction is encoded, enough for "at most" bounds)
+vector<int> totalizer(const vector<int>& lits, int& nextVar, ClauseSink& sink) {
+	if(lits.size() <= 1)
+		return lits ;
+	size_t half = lits.size() / 2 ;
+	vector<int> a = totalizer(vector<int>(lits.begin(), lits.begin() + half), nextVar, sink) ;
+	vector<int> b = totalizer(vector<int>(lits.begin() + half, lits.end()), nextVar, sink) ;
+	vector<int> out (lits.size()), clause ;
+	for(size_t i = 0 ; i < out.size() ; i++)
+		out[i] = nextVar++ ;
+	for(size_t i = 0 ; i < a.size() ; i++) {
+		clause.assign({-a[i], out[i]}) ;
+		sink.addClause(clause) ;
+	}
+	for(size_t j = 0 ; j < b.size() ; j++) {
+		clause.assign({-b[j], out[j]}) ;
+		sink.addClause(clause) ;
+	}
+	for(size_t i = 0 ; i < a.size() ; i++)
+		for(size_t j = 0 ; j < b.size() ; j++) {
+			clause.assign({-a[i], -b[j], out[i + j + 1]}) ;
+			sink.addClause(clause) ;
+		}
+	return out ;
+}
+
+//classes of at least two interchangeable vertices: u and v are twins when
+//every other vertex is joined to both of them by edges of the same cost,
+//swapping them in a tour keeps its cost
+vector<vector<int> > twinClasses(const DistanceMatrix& graph) {
+	int n = graph.size() ;
+	vector<vector<int> > res ;
+	vector<char> done (n, 0) ;
+	for(int u = 0 ; u < n ; u++) {
+		if(done[u])
+			continue ;
+		vector<int> twins (1, u) ;
+		for(int v = u + 1 ; v < n ; v++) {
+			if(done[v])
+				continue ;
+			bool same = true ;
+			for(int w = 0 ; w < n && same ; w++)
+				if(w != u && w != v)
+					same = edgeCost(graph, u, w, DISCRETE) == edgeCost(graph, v, w, DISCRETE) ;
+			if(same) {
+				twins.push_back(v) ;
+				done[v] = 1 ;
+			}
+		}
+		if(twins.size() > 1)
+			res.push_back(twins) ;
+	}
+	return res ;
+}
+
+//x_p,uv : the edge uv is at position p of the cycle. The n positions hold
+//n distinct edges, two consecutive edges share a vertex and every vertex has
+//degree at most 2: the edges form a single cycle through every vertex.
+//h_p : the edge at position p weighs 10, the totalizer counts them.
+HamiltonianEncoding encodeEdges(const DistanceMatrix& graph, ClauseSink& sink, int k, bool symmetry) {
+	int n = graph.size() ;
+	int m = n * (n-1) / 2 ;
+
+	//edge numbering, edges are sorted by (u, v)
+	vector<int> from, to ;
+	vector<vector<int> > edgeId (n, vector<int>(n, -1)) ;
+	for(int u = 0 ; u < n - 1 ; u++)
+		for(int v = u + 1 ; v < n ; v++) {
+			edgeId[u][v] = edgeId[v][u] = from.size() ;
+			from.push_back(u) ;
+			to.push_back(v) ;
+		}
+	auto x = [&](int p, int e) { return 1 + p * m + e ; } ;
+	int heavy = 0 ;
+	for(int e = 0 ; e < m ; e++)
+		if(edgeCost(graph, from[e], to[e], DISCRETE) == 1)
+			heavy++ ;
+
+	HamiltonianEncoding res ;
+	res.n = n ;
+	res.formulation = ENCODING_EDGES ;
+	for(int p = 0 ; p < n ; p++)
+		for(int e = 0 ; e < m ; e++) {
+			EdgeLiteral lit = { x(p, e), from[e], to[e] } ;
+			res.edges.push_back(lit) ;
+		}
+	res.nbVar = n * m ;
+	res.nbClauses = n ;                                 //an edge at every position
+	res.nbClauses += (long) n * m * (m - 1) / 2 ;       //at most one edge per position
+	res.nbClauses += (long) m * n * (n - 1) / 2 ;       //every edge at most once
+	res.nbClauses += (long) n * m ;                     //consecutive edges are adjacent
+	for(int w = 0 ; w < n ; w++) {                      //degree at most 2
+		res.nbVar += n * (n - 1) > 2 ? (n * (n - 1) - 1) * 2 : 0 ;
+		res.nbClauses += sequentialCounterClauses(n * (n - 1), 2) ;
+	}
+	res.nbVar += n ;                                    //h_p
+	res.nbClauses += (long) n * heavy ;
+	totalizerSize(n, res.nbVar, res.nbClauses) ;
+	if(symmetry)
+		res.nbClauses += 2 + (long) (n - 1) * (n - 2) / 2 ;
+	if(k >= 0 && k < n)
+		res.nbClauses++ ;
+
+	sink.begin(res.nbVar, res.nbClauses) ;
+	vector<int> clause ;
+	int nextVar = n * m + 1 ;
+
+	/* à chaque position une arête */
+	for(int p = 0 ; p < n ; p++) {
+		clause.clear() ;
+		for(int e = 0 ; e < m ; e++)
+			clause.push_back(x(p, e)) ;
+		sink.addClause(clause) ;
+	}
+
+	/* à chaque position une seule arête */
+	for(int p = 0 ; p < n ; p++)
+		for(int e1 = 0 ; e1 < m ; e1++)
+			for(int e2 = e1 + 1 ; e2 < m ; e2++) {
+				clause.assign({-x(p, e1), -x(p, e2)}) ;
+				sink.addClause(clause) ;
+			}
+
+	/* à chaque arête une position au max */
+	for(int e = 0 ; e < m ; e++)
+		for(int p1 = 0 ; p1 < n - 1 ; p1++)
+			for(int p2 = p1 + 1 ; p2 < n ; p2++) {
+				clause.assign({-x(p1, e), -x(p2, e)}) ;
+				sink.addClause(clause) ;
+			}
+
+	/* l'arête suivante touche l'arête courante */
+	for(int p = 0 ; p < n ; p++)
+		for(int e = 0 ; e < m ; e++) {
+			clause.assign(1, -x(p, e)) ;
+			for(int w = 0 ; w < n ; w++)
+				if(w != to[e] && w != from[e]) {
+					clause.push_back(x((p + 1) % n, edgeId[from[e]][w])) ;
+					clause.push_back(x((p + 1) % n, edgeId[to[e]][w])) ;
+				}
+			sink.addClause(clause) ;
+		}
+
+	/* chaque sommet est dans au plus deux arêtes */
+	vector<int> incident ;
+	for(int w = 0 ; w < n ; w++) {
+		incident.clear() ;
+		for(int p = 0 ; p < n ; p++)
+			for(int v = 0 ; v < n ; v++)
+				if(v != w)
+					incident.push_back(x(p, edgeId[w][v])) ;
+		sequentialCounter(incident, 2, nextVar, sink) ;
+	}
+
+	/* arêtes de poids 10 */
+	vector<int> h (n) ;
+	for(int p = 0 ; p < n ; p++) {
+		h[p] = nextVar++ ;
+		for(int e = 0 ; e < m ; e++)
+			if(edgeCost(graph, from[e], to[e], DISCRETE) == 1) {
+				clause.assign({-x(p, e), h[p]}) ;
+				sink.addClause(clause) ;
+			}
+	}
+	res.atLeast = totalizer(h, nextVar, sink) ;
+
+	/* symétries : le sommet 0 est entre les positions n-1 et 0, son voisin en
+	   position 0 est plus petit que celui en position n-1 */
+	if(symmetry) {
+		for(int q = 0 ; q < 2 ; q++) {
+			clause.clear() ;
+			for(int v = 1 ; v < n ; v++)
+				clause.push_back(x(q == 0 ? 0 : n - 1, edgeId[0][v])) ;
+			sink.addClause(clause) ;
+		}
+		for(int a = 1 ; a < n ; a++)
+			for(int b = 1 ; b < a ; b++) {
+				clause.assign({-x(0, edgeId[0][a]), -x(n - 1, edgeId[0][b])}) ;
+				sink.addClause(clause) ;
+			}
+	}
+
+	if(k >= 0 && k < n) {
+		clause.assign(1, -res.atLeast[k]) ;
+		sink.addClause(clause) ;
+	}
+	return res ;
+}
+
+//x_v,p : the vertex v is at position p. Every vertex has one position and
+//every position one vertex (at-least-one clause plus a ladder), the graph
+//being complete any such permutation is a cycle. h_p : the edge between the
+//positions p and p+1 weighs 10, when v is at p either h_p holds or the next
+//vertex is joined to v by a light edge.
+//O(n^2) variables, O(n^2) clauses holding O(n^3) literals.
+HamiltonianEncoding encodeVertices(const DistanceMatrix& graph, ClauseSink& sink, int k, bool symmetry) {
+	int n = graph.size() ;
+	auto x = [&](int v, int p) { return 1 + v * n + p ; } ;
+
+	HamiltonianEncoding res ;
+	res.n = n ;
+	res.formulation = ENCODING_VERTICES ;
+	res.nbVar = n * n + 2 * n * (n - 1) + n ;
+	res.nbClauses = 2 * n + 2 * n * sequentialCounterClauses(n, 1) + (long) n * n ;
+	totalizerSize(n, res.nbVar, res.nbClauses) ;
+	vector<vector<int> > twins ;
+	if(symmetry) {
+		res.nbClauses += 1 + (long) (n - 1) * (n - 2) / 2 ;
+		twins = twinClasses(graph) ;
+		for(size_t c = 0 ; c < twins.size() ; c++) {
+			res.nbVar += (twins[c].size() - 1) * (n - 1) ;
+			res.nbClauses += (long) (twins[c].size() - 1) * (2 * n - 1) ;
+		}
+	}
+	if(k >= 0 && k < n)
+		res.nbClauses++ ;
+
+	sink.begin(res.nbVar, res.nbClauses) ;
+	vector<int> clause, lits ;
+	int nextVar = n * n + 1 ;
+
+	/* chaque sommet a exactement une position */
+	for(int v = 0 ; v < n ; v++) {
+		lits.clear() ;
+		for(int p = 0 ; p < n ; p++)
+			lits.push_back(x(v, p)) ;
+		sink.addClause(lits) ;
+		sequentialCounter(lits, 1, nextVar, sink) ;
+	}
+
+	/* chaque position a exactement un sommet */
+	for(int p = 0 ; p < n ; p++) {
+		lits.clear() ;
+		for(int v = 0 ; v < n ; v++)
+			lits.push_back(x(v, p)) ;
+		sink.addClause(lits) ;
+		sequentialCounter(lits, 1, nextVar, sink) ;
+	}
+
+	/* arêtes de poids 10 */
+	vector<int> h (n) ;
+	for(int p = 0 ; p < n ; p++)
+		h[p] = nextVar++ ;
+	for(int p = 0 ; p < n ; p++)
+		for(int u = 0 ; u < n ; u++) {
+			clause.assign({-x(u, p), h[p]}) ;
+			for(int v = 0 ; v < n ; v++)
+				if(v != u && edgeCost(graph, u, v, DISCRETE) == 0)
+					clause.push_back(x(v, (p + 1) % n)) ;
+			sink.addClause(clause) ;
+		}
+	res.atLeast = totalizer(h, nextVar, sink) ;
+
+	/* symétries : rotation (0 en position 0), sens de parcours (le sommet en
+	   position 1 est plus petit que celui en position n-1) et sommets jumeaux
+	   rangés dans l'ordre de leurs numéros */
+	if(symmetry) {
+		clause.assign(1, x(0, 0)) ;
+		sink.addClause(clause) ;
+		for(int a = 1 ; a < n ; a++)
+			for(int b = 1 ; b < a ; b++) {
+				clause.assign({-x(a, 1), -x(b, n - 1)}) ;
+				sink.addClause(clause) ;
+			}
+		for(size_t c = 0 ; c < twins.size() ; c++)
+			for(size_t i = 0 ; i + 1 < twins[c].size() ; i++) {
+				//before[p] : twins[c][i] is at a position <= p
+				int u = twins[c][i], v = twins[c][i + 1] ;
+				vector<int> before (n - 1) ;
+				for(int p = 0 ; p < n - 1 ; p++)
+					before[p] = nextVar++ ;
+				clause.assign({-before[0], x(u, 0)}) ;
+				sink.addClause(clause) ;
+				for(int p = 1 ; p < n - 1 ; p++) {
+					clause.assign({-before[p], before[p - 1], x(u, p)}) ;
+					sink.addClause(clause) ;
+				}
+				clause.assign(1, -x(v, 0)) ;
+				sink.addClause(clause) ;
+				for(int p = 1 ; p < n ; p++) {
+					clause.assign({-x(v, p), before[p - 1]}) ;
+					sink.addClause(clause) ;
+				}
+			}
+	}
+
+	if(k >= 0 && k < n) {
+		clause.assign(1, -res.atLeast[k]) ;
+		sink.addClause(clause) ;
+	}
+	return res ;
+}
+
+HamiltonianEncoding encodeHamiltonian(const DistanceMatrix& graph, ClauseSink& sink, int k, int formulation, bool symmetry) {
+	if(formulation == ENCODING_EDGES)
+		return encodeEdges(graph, sink, k, symmetry) ;
+	return encodeVertices(graph, sink, k, symmetry) ;
+}
+
+vector<int> decodeTour(const HamiltonianEncoding& encoding, const vector<bool>& model) {
+	int n = encoding.n ;
+	if(encoding.formulation == ENCODING_VERTICES) {
+		vector<int> tour (n) ;
+		for(int v = 0 ; v < n ; v++)
+			for(int p = 0 ; p < n ; p++)
+				if(model[1 + v * n + p])
+					tour[p] = v ;
+		return tour ;
+	}
+
+	vector<vector<int> > adjacent (n) ;
+	for(size_t i = 0 ; i < encoding.edges.size() ; i++) {
+		const EdgeLiteral& lit = encoding.edges[i] ;
+		if(model[lit.var]) {
+			adjacent[lit.u].push_back(lit.v) ;
+			adjacent[lit.v].push_back(lit.u) ;
+		}
+	}
+	vector<int> tour (1, 0) ;
+	int prev = -1, cur = 0 ;
+	while((int) tour.size() < n) {
+		int next = adjacent[cur][0] != prev ? adjacent[cur][0] : adjacent[cur][1] ;
+		tour.push_back(next) ;
+		prev = cur ;
+		cur = next ;
+	}
+	return tour ;
+}
@@ -0,0 +1,154 @@
+//SAT resolution with glucose linked in the process
+//The encoder feeds its clauses straight into a glucose SimpSolver, there is
+//no DIMACS file, no child process and no output to parse.
+
+//glucose comes first, its headers do not expect "using namespace std"
+#include "simp/SimpSolver.h"
+#include "../include/Algorithmic.h"
+#include "../include/SATEncoding.h"
+#include "../include/Parallel.h"
+#include <memory>
+
+//loads the clauses into a glucose solver
+class GlucoseSink : public ClauseSink {
+public:
+	GlucoseSink(Glucose::SimpSolver& solver) : solver(solver) {}
+
+	void begin(int nbVar, long) {
+		while(solver.nVars() < nbVar)
+			solver.newVar() ;
+	}
+
+	void addClause(const vector<int>& clause) {
+		lits.clear() ;
+		for(size_t i = 0 ; i < clause.size() ; i++) {
+			int v = abs(clause[i]) - 1 ;
+			while(v >= solver.nVars())
+				solver.newVar() ;
+			lits.push(Glucose::mkLit(v, clause[i] < 0)) ;
+		}
+		solver.addClause_(lits) ;
+	}
+
+private:
+	Glucose::SimpSolver& solver ;
+	Glucose::vec<Glucose::Lit> lits ;
+} ;
+
+//answers "is there a cycle with at most k edges of weight 10 ?"
+//In incremental mode the structure is encoded once and k is an assumption
+//on the totalizer, the learnt clauses are kept from one probe to the next.
+//The totalizer only implies its outputs from the count, so a refuted bound
+//cannot be added as a unit clause: the known lower bound only narrows the
+//bounds that are probed. Otherwise every probe builds a
+//fresh solver with the bound as a unit clause of the encoding.
+class BudgetProbe {
+public:
+	BudgetProbe(const DistanceMatrix& graph, const SATOptions& options) :
+		graph(graph), incremental(options.incremental), formulation(options.encoding), symmetry(options.symmetry) {}
+
+	//on success cost is the cost of the cycle found (at most k)
+	bool probe(int k, int& cost) {
+		if(!incremental || !solver) {
+			solver.reset(new Glucose::SimpSolver()) ;
+			solver->verbosity = -1 ;
+			GlucoseSink sink (*solver) ;
+			encoding = encodeHamiltonian(graph, sink, incremental ? -1 : k, formulation, symmetry) ;
+			for(size_t j = 0 ; j < encoding.atLeast.size() ; j++)
+				solver->setFrozen(encoding.atLeast[j] - 1, true) ;
+		}
+		Glucose::vec<Glucose::Lit> assumptions ;
+		if(incremental)
+			assumptions.push(~Glucose::mkLit(encoding.atLeast[k] - 1)) ;
+		if(!solver->okay() || !solver->solve(assumptions))
+			return false ;
+
+		vector<bool> model (encoding.nbVar + 1, false) ;
+		for(int v = 0 ; v < encoding.nbVar && v < solver->model.size() ; v++)
+			model[v + 1] = solver->model[v] == l_True ;
+		cost = poids(graph, decodeTour(encoding, model), DISCRETE) ;
+		return true ;
+	}
+
+private:
+	const DistanceMatrix& graph ;
+	bool incremental ;
+	int formulation ;
+	bool symmetry ;
+	unique_ptr<Glucose::SimpSolver> solver ;
+	HamiltonianEncoding encoding ;
+} ;
+
+//next bounds to probe in [lower, upper), upper being satisfiable
+vector<int> nextProbes(int search, int lower, int upper, int count, int& step) {
+	vector<int> res ;
+	if(search == SAT_LINEAR) {
+		for(int k = lower ; k < upper && (int) res.size() < count ; k++)
+			res.push_back(k) ;
+	}
+	else if(search == SAT_GALLOPING && step > 0) {
+		//downwards from the upper bound with doubling steps
+		for(int i = 0 ; i < count && upper - step >= lower ; i++) {
+			res.push_back(upper - step) ;
+			step *= 2 ;
+		}
+		if(res.empty())
+			res.push_back(lower) ;
+	}
+	else {
+		//count cuts spread evenly in the interval
+		for(int i = 1 ; i <= count ; i++) {
+			int k = lower + (long) (upper - lower) * i / (count + 1) ;
+			if(k < upper && (res.empty() || k > res.back()))
+				res.push_back(k) ;
+		}
+		if(res.empty())
+			res.push_back(lower) ;
+	}
+	return res ;
+}
+
+int SAT(const DistanceMatrix& graph, const SATOptions& options){
+	int n = graph.size() ;
+	vector<int> tour (n) ;
+	for(int i = 0 ; i < n ; i++)
+		tour[i] = i ;
+	if(n < 3)
+		return poids(graph, tour, DISCRETE) ;
+
+	//a tour gives the first satisfiable bound
+	int upper = options.upperBound ;
+	if(upper < 0)
+		upper = poids(graph, warmStart(graph, DISCRETE), DISCRETE) ;
+	int lower = max(options.lowerBound, 0) ;
+
+	int threads = options.threads > 0 ? options.threads : hardwareThreads() ;
+	if(upper > 0 && lower == 0 && n <= options.precheck && n <= HAMILTONIAN_MAX) {
+		if(hamiltonianCycle(graph, tour, threads))
+			return 0 ;
+		lower = 1 ;
+	}
+	vector<unique_ptr<BudgetProbe> > probes (threads) ;
+	for(int t = 0 ; t < threads ; t++)
+		probes[t].reset(new BudgetProbe(graph, options)) ;
+
+	int step = 1 ;
+	while(lower < upper) {
+		vector<int> ks = nextProbes(options.search, lower, upper, threads, step) ;
+		vector<char> sat (ks.size()) ;
+		vector<int> cost (ks.size()) ;
+		parallelFor(ks.size(), [&](int i, int worker) {
+			sat[i] = probes[worker]->probe(ks[i], cost[i]) ;
+		}, threads) ;
+
+		for(size_t i = 0 ; i < ks.size() ; i++) {
+			if(sat[i])
+				upper = min(upper, cost[i]) ;
+			else {
+				lower = max(lower, ks[i] + 1) ;
+				step = 0 ; //the galloping phase ends at the first refuted bound
+			}
+		}
+	}
+	return upper ;
+}
@@ -0,0 +1,241 @@
+//Minimum spanning tree engines
+//Kruskal with a union-find structure and a counting (or radix) sort of the
+//integer weights for sparse graphs, Prim in O(n^2) on the flat matrix for
+//dense ones. The graphs are complete, the "sparse" part of a graph is made
+//of the edges lighter than its heaviest weight (the non-edges of DISCRETE
+//instances weigh 10).
+
+#include "../include/Algorithmic.h"
+#include <climits>
+#include <stdint.h>
+
+#if defined(__SSE4_1__)
+#include <smmintrin.h>
+#endif
+
+#define KRUSKAL_DENSITY 0.25 //Kruskal is used below this fraction of light edges
+
+//union-find with path halving and union by rank
+struct DisjointSets {
+	vector<int> parent ;
+	vector<unsigned char> rank ;
+
+	DisjointSets(int n) : parent(n), rank(n, 0) {
+		for(int i = 0 ; i < n ; i++)
+			parent[i] = i ;
+	}
+
+	int find(int x) {
+		while(parent[x] != x) {
+			parent[x] = parent[parent[x]] ;
+			x = parent[x] ;
+		}
+		return x ;
+	}
+
+	bool unite(int x, int y) {
+		x = find(x) ;
+		y = find(y) ;
+		if(x == y)
+			return false ;
+		if(rank[x] < rank[y])
+			swap(x, y) ;
+		parent[y] = x ;
+		if(rank[x] == rank[y])
+			rank[x]++ ;
+		return true ;
+	}
+} ;
+
+//stable sort of the edge indices by weight: one counting pass when the range
+//of weights is small, two passes on 16 bits digits otherwise
+void sortEdges(const vector<int>& weight, vector<int>& order) {
+	int m = weight.size() ;
+	int minW = INT_MAX, maxW = INT_MIN ;
+	for(int e = 0 ; e < m ; e++) {
+		if(weight[e] < minW)
+			minW = weight[e] ;
+		if(weight[e] > maxW)
+			maxW = weight[e] ;
+	}
+	order.resize(m) ;
+	if(m == 0)
+		return ;
+
+	long range = (long) maxW - minW + 1 ;
+	if(range <= m || range <= 1 << 16) {
+		vector<int> count (range + 1, 0) ;
+		for(int e = 0 ; e < m ; e++)
+			count[weight[e] - minW + 1]++ ;
+		for(long k = 1 ; k <= range ; k++)
+			count[k] += count[k - 1] ;
+		for(int e = 0 ; e < m ; e++)
+			order[count[weight[e] - minW]++] = e ;
+		return ;
+	}
+
+	vector<int> tmp (m) ;
+	for(int e = 0 ; e < m ; e++)
+		tmp[e] = e ;
+	for(int shift = 0 ; shift < 32 ; shift += 16) {
+		vector<int> count ((1 << 16) + 1, 0) ;
+		for(int e = 0 ; e < m ; e++)
+			count[((uint32_t) (weight[tmp[e]] - minW) >> shift & 0xFFFF) + 1]++ ;
+		for(int k = 1 ; k <= 1 << 16 ; k++)
+			count[k] += count[k - 1] ;
+		for(int e = 0 ; e < m ; e++)
+			order[count[(uint32_t) (weight[tmp[e]] - minW) >> shift & 0xFFFF]++] = tmp[e] ;
+		tmp.swap(order) ;
+	}
+	order.swap(tmp) ;
+}
+
+//Kruskal on the light edges, the components left are then joined by heavy edges
+vector<pair<int, int> > kruskal(const DistanceMatrix& graph, int heavy) {
+	int n = graph.size() ;
+	vector<int> from, to, weight ;
+	for(int u = 0 ; u < n ; u++)
+		for(int v = u + 1 ; v < n ; v++)
+			if(graph(u, v) < heavy) {
+				from.push_back(u) ;
+				to.push_back(v) ;
+				weight.push_back(graph(u, v)) ;
+			}
+
+	vector<int> order ;
+	sortEdges(weight, order) ;
+
+	vector<pair<int, int> > tree ;
+	DisjointSets sets (n) ;
+	for(size_t k = 0 ; k < order.size() && (int) tree.size() < n - 1 ; k++) {
+		int e = order[k] ;
+		if(sets.unite(from[e], to[e]))
+			tree.push_back(make_pair(from[e], to[e])) ;
+	}
+
+	//every edge between two components weighs 'heavy'
+	for(int v = 1 ; v < n && (int) tree.size() < n - 1 ; v++)
+		if(sets.unite(0, v))
+			tree.push_back(make_pair(0, v)) ;
+	return tree ;
+}
+
+//index of the smallest key, the first one on ties (keys are padded with INT_MAX up to a multiple of 4)
+int argMin(const int32_t* key, int n) {
+#if defined(__SSE4_1__)
+	__m128i best = _mm_set1_epi32(INT_MAX) ;
+	for(int i = 0 ; i < n ; i += 4)
+		best = _mm_min_epi32(best, _mm_load_si128((const __m128i*) (key + i))) ;
+	best = _mm_min_epi32(best, _mm_shuffle_epi32(best, _MM_SHUFFLE(1, 0, 3, 2))) ;
+	best = _mm_min_epi32(best, _mm_shuffle_epi32(best, _MM_SHUFFLE(2, 3, 0, 1))) ;
+	for(int i = 0 ; i < n ; i += 4) {
+		int mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(best, _mm_load_si128((const __m128i*) (key + i))))) ;
+		if(mask != 0)
+			return i + __builtin_ctz(mask) ;
+	}
+	return 0 ;
+#else
+	int res = 0 ;
+	for(int i = 1 ; i < n ; i++)
+		if(key[i] < key[res])
+			res = i ;
+	return res ;
+#endif
+}
+
+//relaxes the keys of the vertices not in the tree with the row of the vertex u just added
+template<typename Weight>
+void relax(const Weight* row, int n, int u, int32_t* key, int32_t* parent, const int32_t* done) {
+	for(int v = 0 ; v < n ; v++) {
+		int32_t w = row[v] ;
+		bool better = (w < key[v]) & (done[v] == 0) ;
+		key[v] = better ? w : key[v] ;
+		parent[v] = better ? u : parent[v] ;
+	}
+}
+
+vector<pair<int, int> > prim(const DistanceMatrix& graph) {
+	int n = graph.size() ;
+	int padded = (n + 3) & ~3 ;
+	//key, parent and done are aligned for the vector loads of argMin
+	vector<int32_t> storage (3 * padded + 4) ;
+	int32_t* base = &storage[0] ;
+	while(((uintptr_t) base & 15) != 0)
+		base++ ;
+	int32_t* key = base ;
+	int32_t* parent = base + padded ;
+	int32_t* done = base + 2 * padded ;
+	for(int v = 0 ; v < padded ; v++) {
+		key[v] = INT_MAX ;
+		parent[v] = -1 ;
+		done[v] = v < n ? 0 : 1 ;
+	}
+
+	vector<pair<int, int> > tree ;
+	key[0] = 0 ;
+	for(int k = 0 ; k < n ; k++) {
+		int u = argMin(key, padded) ;
+		if(parent[u] != -1)
+			tree.push_back(make_pair(parent[u], u)) ;
+		key[u] = INT_MAX ;
+		done[u] = 1 ;
+		switch(graph.width()) {
+		case WIDTH8 :
+			relax(graph.row8(u), n, u, key, parent, done) ;
+			break ;
+		case WIDTH16 :
+			relax(graph.row16(u), n, u, key, parent, done) ;
+			break ;
+		default :
+			relax(graph.row32(u), n, u, key, parent, done) ;
+		}
+	}
+	return tree ;
+}
+
+//heaviest weight of the graph and number of edges lighter than it
+template<typename Weight>
+void lightEdges(const DistanceMatrix& graph, int& heavy, long& light) {
+	int n = graph.size() ;
+	Weight max = 0 ;
+	for(int u = 0 ; u < n ; u++) {
+		const Weight* row = graph.row<Weight>(u) ;
+		for(int v = u + 1 ; v < n ; v++)
+			max = row[v] > max ? row[v] : max ;
+	}
+	light = 0 ;
+	for(int u = 0 ; u < n ; u++) {
+		const Weight* row = graph.row<Weight>(u) ;
+		long count = 0 ;
+		for(int v = u + 1 ; v < n ; v++)
+			count += row[v] < max ;
+		light += count ;
+	}
+	heavy = max ;
+}
+
+vector<pair<int, int> > spanningTree(const DistanceMatrix& graph, int engine) {
+	int n = graph.size() ;
+	if(n <= 1)
+		return vector<pair<int, int> >() ;
+	if(engine == MST_PRIM)
+		return prim(graph) ;
+
+	int heavy ;
+	long light ;
+	switch(graph.width()) {
+	case WIDTH8 :
+		lightEdges<uint8_t>(graph, heavy, light) ;
+		break ;
+	case WIDTH16 :
+		lightEdges<uint16_t>(graph, heavy, light) ;
+		break ;
+	default :
+		lightEdges<int32_t>(graph, heavy, light) ;
+	}
+	if(engine == MST_AUTO)
+		engine = light < KRUSKAL_DENSITY * n * (n - 1) / 2 ? MST_KRUSKAL : MST_PRIM ;
+	if(engine == MST_KRUSKAL)
+		return kruskal(graph, heavy) ;
+	return prim(graph) ;
+}
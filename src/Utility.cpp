@@ -1,9 +1,12 @@
 #include "../include/Utility.h"
+#include "../include/DimacsWriter.h"
+#include "../include/Random.h"
+#include "../include/Generators.h"
 #include <fstream>
 #include <string>
 #include <iostream>
-#include <ctime>
 #include <sstream>
+#include <cstdlib>
 
 #ifdef _MSC_VER // Windows
 #include <process.h>
@@ -12,22 +15,15 @@
 
 int getInteger(string src, int* i) ;
 
-vector<vector<int> > generateRandomGraph(int n, int maxWeight /*= 10*/) {
-	/* initialize random seed: */
-	srand (time(NULL));
-
-	vector<vector<int> > res ;
-
-	for(int i = 0 ; i < n ; i++) {
-		vector<int> tmp (n,0);
-		res.push_back(tmp) ;
-	}
+DistanceMatrix generateRandomGraph(int n, int maxWeight, uint64_t seed) {
+	Random rng (seed) ;
+	DistanceMatrix res (n, widthFor(maxWeight)) ;
 
 	for(int i = 0 ; i < n ; i++) {
 		for(int j = i + 1; j < n ; j++) {
-			int tmp = rand() % maxWeight + 1 ;
-			res[i][j] = tmp ;
-			res[j][i] = tmp ;
+			int tmp = rng.below(maxWeight) + 1 ;
+			res.set(i, j, tmp) ;
+			res.set(j, i, tmp) ;
 		}
 	}
 	return res ;
@@ -41,7 +37,7 @@ vector<vector<int> > generateRandomGraph(int n, int maxWeight /*= 10*/) {
  * ...
  * n - 1 : ...
  */
-vector<vector<int> > readGraphFromMatrix(char const * fileName) {
+DistanceMatrix readGraphFromMatrix(char const * fileName) {
 	/*we open the stream */
 	std::fstream fs ;
 	fs.open (fileName, std::fstream::in) ;
@@ -52,26 +48,30 @@ vector<vector<int> > readGraphFromMatrix(char const * fileName) {
 	int index = 1 ;
 	int n = getInteger(tmp, &index) ; /* and store it in n*/
 
-	/* we initiate the matrix */
-	vector<vector<int> > res ;
-	for(int i = 0 ; i < n ; i++) {
-		vector<int> tmp (n,0) ;
-		res.push_back(tmp) ;
-	}
+	/* we read the weights first, the element width of the matrix depends on the largest one */
+	vector<int> weights ((size_t) n * n, 0) ;
+	int maxWeight = 0 ;
 
 	/*for each nodes we extract the vector of weight*/
 	for(int i = 0 ; i < n ; i++) {
 		getline(fs, tmp) ;
 
-		int index = 1 ;
+		//the node number starts the line
+		int index = 0 ;
 		int currNode = getInteger(tmp,&index) ;
 
 		for(int neighboor = 0 ; neighboor < n ; neighboor++) {
 			int weight = getInteger(tmp,&index) ;
-			res[currNode][neighboor] = weight ;
+			weights[(size_t) currNode * n + neighboor] = weight ;
+			if(weight > maxWeight)
+				maxWeight = weight ;
 		}
 	}
 
+	DistanceMatrix res (n, widthFor(maxWeight)) ;
+	for(int i = 0 ; i < n ; i++)
+		for(int j = 0 ; j < n ; j++)
+			res.set(i, j, weights[(size_t) i * n + j]) ;
 	return res ;
 }
 
@@ -83,7 +83,7 @@ vector<vector<int> > readGraphFromMatrix(char const * fileName) {
  * ...
  * n - 1 : ...
  */
-vector<vector<int> > readGraphFromAdjList(char const * fileName) {
+DistanceMatrix readGraphFromAdjList(char const * fileName) {
 	/*we open the stream */
 	std::fstream fs ;
 	fs.open(fileName, std::fstream::in) ;
@@ -95,12 +95,9 @@ vector<vector<int> > readGraphFromAdjList(char const * fileName) {
 	int n = getInteger(tmp, &index) ; /* and store it in n*/
 
 	/* we initiate the matrix */
-	vector<vector<int> > res ;
-	for(int i = 0 ; i < n ; i++) {
-		vector<int> tmp (n,10) ;
-		res.push_back(tmp) ;
-		res[i][i] = 0 ;
-	}
+	DistanceMatrix res (n, WIDTH8, 10) ;
+	for(int i = 0 ; i < n ; i++)
+		res.set(i, i, 0) ;
 
 	/*for each nodes we extract the adjacency list*/
 	for(int i = 0 ; i < n ; i++) {
@@ -110,8 +107,8 @@ vector<vector<int> > readGraphFromAdjList(char const * fileName) {
 
 		int neighboor = getInteger(tmp,&index) ;
 		while(neighboor != -1) {
-			res[currNode][neighboor] = 1 ;
-			res[neighboor][currNode] = 1 ;
+			res.set(currNode, neighboor, 1) ;
+			res.set(neighboor, currNode, 1) ;
 			neighboor = getInteger(tmp,&index) ;
 		}
 	}
@@ -137,23 +134,13 @@ int getInteger(string src, int* i) {
 	return res ;
 }
 
-vector<vector<int> > generateGraph(int n, float p){
-	std::string nStr;
-	std::string pStr;
-
-	/*
-	std::ostringstream ss;
-	ss << p;
-	std::string s(ss.str());
-	*/
-
-		nStr = std::to_string(n);
-	pStr = std::to_string(p);
+DistanceMatrix generateGraph(int n, float p, uint64_t seed){
+	return gnp(n, p, seed);
+}
 
-	std::string cmd = "./gengraph -format list random "+ nStr + " "+ pStr +" > out.txt";
-	system(cmd.c_str());
-	vector<vector<int> > ret = readGraphFromAdjList("./out.txt");
-	return ret;
+string tempDirectory() {
+	const char* dir = getenv("TMPDIR") ;
+	return dir != NULL && dir[0] != '\0' ? dir : "/tmp" ;
 }
 
 void writeResult(const char* fileName, vector<double> t, vector<int> n, const char* fct) {
@@ -169,194 +156,42 @@ void writeResult(const char* fileName, vector<double> t, vector<int> n, const ch
 	cout << "done writing results" << endl ;
 }
 
-void writeGraph(const char* fileName, vector<vector<int> > graph) {
+bool writeGraph(const char* fileName, const DistanceMatrix& graph) {
 	ofstream os ;
 	os.open(fileName) ;
 
 	os << "N = " << graph.size() << endl;
 	for(int i = 0 ; i < graph.size(); i++) {
 		os << i << " : " ;
-		for(int j = 0 ; j < graph[i].size() ; j++)
-			os << graph[i][j] << " " ;
+		for(int j = 0 ; j < graph.size() ; j++)
+			os << graph(i, j) << " " ;
 		os << endl;
 	}
 	os.close();
-}
-
-void graphToSAT(const char* fileName, vector<vector<int> > graph, int k) {
-	int n = graph.size() ;
-	int m = n * (n-1) / 2 ;
-	int nbVar = m * n ; //nb d'arêtes x taille du cycle <=> nb de x_i,u,v
-	nbVar += k * n ; //taille du cycle * nb d'arêtes de poids 10 ;
-	int nbC = n ;
-	nbC += n * (m * (m-1) / 2) ;
-	nbC += m * (n * (n-1) / 2) ;
-	nbC += n * m * 2 ;
-	nbC += n * k ;
-	nbC += k ;
-	nbC += n * (k * (k-1) / 2) ;
-	nbC += k * n * (n-1)/2 ;
-
-	int cpt = 1 ;
-	vector<vector<vector<int> > > var1 ;
-	vector<vector<int> > var2 ;
-	for(int i1 = 1 ; i1 <= n ; i1++) {
-		vector<vector<int> > tmp1 ;
-		for(int i2 = 1 ; i2 <= n ; i2++) {
-			vector<int> tmp2 ;
-			for(int i3 = 1 ; i3 <= n ; i3++) {
-				if(i3 > i2) {
-					tmp2.push_back(cpt) ;
-					cpt++ ;
-				}
-				else
-					tmp2.push_back(0);
-			}
-			tmp1.push_back(tmp2) ;
-		}
-		var1.push_back(tmp1) ;
-	} 
-
-	for(int i2 = 1 ; i2 <= k ; i2++) {
-		vector<int> tmp2 ;
-		for(int i3 = 1 ; i3 <= n ; i3++) {
-			tmp2.push_back(cpt) ;
-			cpt++ ;
-		}
-		var2.push_back(tmp2) ;
-	} 
-
-	ofstream os ;
-	os.open(fileName) ;
-	os << "p cnf " << nbVar << " " << nbC << endl;
-
-	/*	*****	*/
-	/* on commence à générer la formule sat*/
-	/*	*****	*/
-
-	cpt = 0;
-	/*à chaque position une arête*/
-	for(int p = 0 ; p < n ; p++) { 
-		for(int u = 0 ; u < n -1; u++) {
-			for(int v = u + 1 ; v < n ; v++) {
-				os << var1[p][u][v] << " ";
-			}
-		}
-		os << "0" << endl; 
-		cpt++ ;
-	}
-
-	cpt = 0;
-	/* à cahque position une seul arête*/
-	for(int p = 0 ; p < n ; p++) {
-		for(int u1 = 0 ; u1 < n -1; u1++) {
-			for(int v1 = u1 + 1 ; v1 < n ; v1++ ) {
-				int u2 = u1 ;
-				for(int v2 = v1+1 ; v2 < n ; v2++) {
-					cpt++ ;
-					os << "-" << var1[p][u1][v1] << " " << "-" << var1[p][u2][v2] << " 0" << endl;
-				}
-				for(u2 = u1 + 1; u2 < n -1; u2++) {
-					for(int v2 = u2+1; v2 < n ; v2++) {
-						cpt++ ;
-						os << "-" << var1[p][u1][v1] << " " << "-" << var1[p][u2][v2] << " 0" << endl;
-					}
-				}
-			}
-		}
-	}
-
-	cpt = 0 ;
-	/* à chaque arête une position au max*/
-	for(int u = 0; u < n -1; u++) {
-		for(int v = u+1; v < n ; v++) {
-			for(int p1 = 0 ; p1 < n - 1; p1++) {
-				for(int p2 = p1 + 1; p2 < n ; p2++){
-					cpt++;
-					os << "-" << var1[p1][u][v] << " " << "-" << var1[p2][u][v] << " 0" << endl;
-				}
-			}
-		}
-	}
-
-	cpt = 0 ;
-	/* on veut un cycle */
-	for(int p = 0 ; p < n ; p++) {
-		for(int u = 0 ; u < n -1; u++) {
-			for(int v = u+1 ; v < n ; v++) {
-				os << "-" << var1[p][u][v] << " ";
-				for(int w = 0 ; w < n ; w++) {
-					if(w < v) {
-						os << var1[(p+1)%n][w][v] << " ";
-					}
-					else if (v < w) {
-						os << var1[(p+1)%n][v][w] << " ";
-					}
-				} 
-				os << "0" << endl ;
-				cpt++;
-				os << "-" << var1[p][u][v] << " ";
-				for(int w = 0 ; w < n ; w++) {
-					if(w < u) {
-						os << var1[(p+n-1)%n][w][u] << " ";
-					}
-					else if (u < w) {
-						os << var1[(p+n-1)%n][u][w] << " ";
-					}
-				} 
-				os << "0" << endl ;
-				cpt++;
-			}
-		}
-	}
-
-	cpt = 0 ;
-	/* soit en position p il n'y a pas d'arête de poids 10 soit x_ij est vrai*/ 
-	for(int p = 0 ; p < n ; p++) {
-		for( int j = 0 ; j < k ; j++) {
-			os << "-" << var2[j][p] << " " ;
-			for(int u = 0 ; u < n -1; u++) {
-				for(int v = u + 1; v < n ; v++) {
-					if(graph[u][v] == 10)
-						os << var1[p][u][v] << " " ;
-				}
-			}
-			cpt++;
-			os << "0" << endl ;
-		}
-	}
-
-	cpt = 0;
-	/* pour chaque j au moins une p valide, on a bien k arête de poids  10*/
-	for(int j = 0 ; j < k ; j++) {
-		for(int p = 0 ; p < n ; p++) {
-			os << var2[j][p] << " ";
-		}
-		cpt++;
-		os << "0" << endl;
-	}
-
-	cpt = 0;
-	/*pour chaque position de poids 10, on a au plus une arête*/
-	for(int p = 0 ; p < n ; p++ ) {
-		for(int j1 = 0 ; j1 < k -1; j1++) {
-			for(int j2 = j1 + 1 ; j2 < k ; j2++) {
-				cpt++;
-				os << "-" << var2[j1][p] << " " << "-" << var2[j2][p] << " 0" << endl ;
-			}
-		}
-	}
-
-	cpt = 0 ;
-	/* pour chaque position de poids 10 on a au plus une arête dans le cycle*/  
-	for(int p1 = 0 ; p1 < n -1; p1++) {
-		for(int p2 = p1 + 1 ; p2 < n ; p2++) {
-			for(int j = 0 ; j < k ; j++) {
-				cpt++;
-				os << "-" << var2[j][p1] << " " << "-" << var2[j][p2] << " 0" << endl ;
-			}
-		}
+	if(!os) {
+		cerr << fileName << ": cannot be written" << endl ;
+		return false ;
 	}
+	return true ;
+}
 
-	os.close() ;
-}
\ No newline at end of file
+bool graphToSAT(const char* target, const DistanceMatrix& graph, int k, int formulation, bool symmetry) {
+	//a name ending with .gz is compressed, glucose reads it as is
+	string name (target) ;
+	bool gzip = name.size() > 3 && name.compare(name.size() - 3, 3, ".gz") == 0 ;
+	int mode = gzip ? DIMACS_GZIP : DIMACS_FILE ;
+	if(name == "-")
+		name = "/dev/stdout" ;
+	else if(!name.empty() && name[0] == '|') {
+		name.erase(0, 1) ;
+		mode = DIMACS_PIPE ;
+	}
+	DimacsWriter writer (name.c_str(), mode) ;
+	if(writer.good())
+		encodeHamiltonian(graph, writer, k, formulation, symmetry) ;
+	if(!writer.close()) {
+		cerr << target << ": cannot be written" << endl ;
+		return false ;
+	}
+	return true ;
+}
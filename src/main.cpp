@@ -1,7 +1,11 @@
 #include "../include/Algorithmic.h"
 #include "../include/Utility.h"
+#include "../include/Benchmark.h"
+#include "../include/Results.h"
+#include "../include/Corpus.h"
 #include <vector>
 #include <iostream>
+#include <fstream>
 #include <cstring>
 #include <string>
 
@@ -9,190 +13,67 @@ using namespace std ;
 
 void printUsage(){
 	cout<<"Usage: ./SATan mode type"<<endl;
+	cout<<"       ./SATan bench config"<<endl;
+	cout<<"       ./SATan corpus config directory"<<endl;
+	cout<<"       ./SATan compare base.csv candidate.csv [alpha]"<<endl;
+	cout<<"       ./SATan cnf graph k [file|file.gz|\"|command\"|-] [vertices|edges] [symmetry|nosymmetry]"<<endl;
 	cout<<"Available modes: discrete, weighted" << endl;
-	cout<<"Available types for discrete: brute, bt, mst, sat" << endl;
-	cout<<"Available types for weighted: brute, bt, mst" << endl;
+	cout<<"Available types for discrete: brute, bt, mst, mst+2opt, lk, pathcover, pathcover-exact, christofides, sat, dp, bnb" << endl;
+	cout<<"Available types for weighted: brute, bt, mst, mst+2opt, lk, christofides, dp, bnb" << endl;
 }
 
-void useDiscrete(Algorithms ALGO){
-	vector<double> t;
-	vector<int> n;
-	if(ALGO == BRUTE) {
-		for(int i = 10 ; i <= 100 ; i = i+10) {
-			n.push_back(i);
-			double res = 0 ;
-			for(int j = 0 ; j < 10 ; j++) {
-				vector<vector<int> > graph = generateGraph(i,0.6) ;
-				clock_t t;
-		  		t = clock();
-		  		bruteForce(graph, DISCRETE);
-		  		t = clock() - t;
-		  		res += (double) ((float)t)/CLOCKS_PER_SEC;
-			}
-			res = res / 10;
-			t.push_back(res);
-			string fileName("discrete_brute_") ;
-			fileName.append(to_string(i)) ;
-			writeResult(fileName.c_str(), t, n, "brute for discrete") ;
-		}
-	}
-	else if(ALGO == BT) {
-		for(int i = 10 ; i <= 100 ; i = i+10) {
-			n.push_back(i);
-			double res = 0 ;
-			for(int j = 0 ; j < 10 ; j++) {
-				vector<vector<int> > graph = generateGraph(i,0.6) ;
-				clock_t t;
-		  		t = clock();
-		  		backTracking(graph, DISCRETE);
-		  		t = clock() - t;
-		  		res += (double) ((float)t)/CLOCKS_PER_SEC;
-			}
-			res = res / 10;
-			t.push_back(res);
-			string fileName("discrete_bt_") ;
-			fileName.append(to_string(i)) ;
-			writeResult(fileName.c_str(), t, n, "backTracking for discrete") ;
-		}
-
-	}
-	else if(ALGO == MST) {
-		for(int i = 10 ; i <= 100 ; i = i+10) {
-			n.push_back(i);
-			double res = 0 ;
-			for(int j = 0 ; j < 10 ; j++) {
-				vector<vector<int> > graph = generateGraph(i,0.6) ;
-				clock_t t;
-		  		t = clock();
-		  		minimumSpanningTree(graph);
-		  		t = clock() - t;
-		  		res += (double) ((float)t)/CLOCKS_PER_SEC;
-			}
-			res = res / 10;
-			t.push_back(res);
-			string fileName("discrete_mst_") ;
-			fileName.append(to_string(i)) ;
-			writeResult(fileName.c_str(), t, n, "minimumSpanningTree for discrete") ;
-		}
-
-	}
-	else if (ALGO == sat) {
-		for(int i = 10 ; i <= 100 ; i = i+10) {
-			n.push_back(i);
-			double res = 0 ;
-			for(int j = 0 ; j < 10 ; j++) {
-				vector<vector<int> > graph = generateGraph(i,0.6) ;
-				clock_t t;
-		  		t = clock();
-		  		SAT(graph);
-		  		t = clock() - t;
-		  		res += (double) ((float)t)/CLOCKS_PER_SEC;
-			}
-			res = res / 10;
-			t.push_back(res);
-			string fileName("discrete_sat_") ;
-			fileName.append(to_string(i)) ;
-			writeResult(fileName.c_str(), t, n, "sat for discrete") ;
-		}
-
-	}
-}
-
-void useWeighted(Algorithms ALGO){
-	vector<double> t;
-	vector<int> n;
-	if(ALGO == BRUTE) {
-		for(int i = 10 ; i <= 100 ; i = i+10) {
-			n.push_back(i);
-			double res = 0 ;
-			for(int j = 0 ; j < 10 ; j++) {
-				vector<vector<int> > graph = generateRandomGraph(i,i*10) ;
-				clock_t t;
-		  		t = clock();
-		  		bruteForce(graph);
-		  		t = clock() - t;
-		  		res += (double) ((float)t)/CLOCKS_PER_SEC;
-			}
-			res = res / 10;
-			t.push_back(res);
-			string fileName("weighted_brute_") ;
-			fileName.append(to_string(i)) ;
-			writeResult(fileName.c_str(), t, n, "brute for weighted") ;
-		}
+int main(int argc, const char* argv[]){
+	if(argc < 3)
+		printUsage();		
+	else if(strcmp(argv[1], "bench") == 0){
+		BenchmarkConfig config ;
+		if(!readBenchmarkConfig(argv[2], config) || !runBenchmark(config))
+			return EXIT_FAILURE;
 	}
-	else if(ALGO == BT) {
-		for(int i = 10 ; i <= 100 ; i = i+10) {
-			n.push_back(i);
-			double res = 0 ;
-			for(int j = 0 ; j < 10 ; j++) {
-				vector<vector<int> > graph = generateRandomGraph(i,i*10) ;
-				clock_t t;
-		  		t = clock();
-		  		backTracking(graph);
-		  		t = clock() - t;
-		  		res += (double) ((float)t)/CLOCKS_PER_SEC;
-			}
-			res = res / 10;
-			t.push_back(res);
-			string fileName("weighted_bt") ;
-			fileName.append(to_string(i)) ;
-			writeResult(fileName.c_str(), t, n, "backTracking for weighted") ;
+	else if(strcmp(argv[1], "corpus") == 0){
+		BenchmarkConfig config ;
+		if(argc < 4){
+			printUsage();
+			return EXIT_FAILURE;
 		}
+		if(!readBenchmarkConfig(argv[2], config) || !writeCorpus(config, argv[3]))
+			return EXIT_FAILURE;
 	}
-	else if(ALGO == MST) {
-		for(int i = 10 ; i <= 100 ; i = i+10) {
-			n.push_back(i);
-			double res = 0 ;
-			for(int j = 0 ; j < 10 ; j++) {
-				vector<vector<int> > graph = generateRandomGraph(i,i*10) ;
-				clock_t t;
-		  		t = clock();
-		  		minimumSpanningTree(graph);
-		  		t = clock() - t;
-		  		res += (double) ((float)t)/CLOCKS_PER_SEC;
-			}
-			res = res / 10;
-			t.push_back(res);
-			string fileName("weighted_mst_") ;
-			fileName.append(to_string(i)) ;
-			writeResult(fileName.c_str(), t, n, "mst for weighted") ;
+	else if(strcmp(argv[1], "compare") == 0){
+		if(argc < 4){
+			printUsage();
+			return EXIT_FAILURE;
 		}
+		int regressions = compareResults(argv[2], argv[3], argc > 4 ? atof(argv[4]) : COMPARE_ALPHA);
+		return regressions == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
 	}
-}
-
-int main(int argc, const char* argv[]){
-	if(argc < 2)
-		printUsage();		
-	else if(strcmp(argv[1], "discrete") == 0){
-		if(argc < 3)
+	else if(strcmp(argv[1], "cnf") == 0){
+		if(argc < 4){
 			printUsage();
-		else if(strcmp(argv[2], "brute") == 0){
-			useDiscrete(BRUTE);
-		}
-		else if(strcmp(argv[2], "bt") == 0){
-			useDiscrete(BT);
+			return EXIT_FAILURE;
 		}
-		else if(strcmp(argv[2], "mst") == 0){
-			useDiscrete(MST);
+		const char* target = argc > 4 ? argv[4] : "-";
+		string encoding = argc > 5 ? argv[5] : "vertices";
+		string symmetry = argc > 6 ? argv[6] : "symmetry";
+		if((encoding != "vertices" && encoding != "edges") || (symmetry != "symmetry" && symmetry != "nosymmetry")){
+			printUsage();
+			return EXIT_FAILURE;
 		}
-		else if(strcmp(argv[2], "sat") == 0){
-			useDiscrete(sat);
+		if(!ifstream(argv[2])){
+			cerr << argv[2] << ": cannot be read" << endl;
+			return EXIT_FAILURE;
 		}
-		else printUsage();
+		DistanceMatrix graph = readGraphFromMatrix(argv[2]);
+		int formulation = encoding == "edges" ? ENCODING_EDGES : ENCODING_VERTICES;
+		if(!graphToSAT(target, graph, atoi(argv[3]), formulation, symmetry == "symmetry"))
+			return EXIT_FAILURE;
 	}
-	else if(strcmp(argv[1], "weighted") == 0){
-		if(argc < 3)
+	else if(strcmp(argv[1], "discrete") == 0 || strcmp(argv[1], "weighted") == 0){
+		int mode = strcmp(argv[1], "discrete") == 0 ? DISCRETE : WEIGHTED ;
+		if(!knownAlgorithm(argv[2], mode))
 			printUsage();
-		else if(strcmp(argv[2], "brute") == 0){
-			useWeighted(BRUTE);
-		}
-		else if(strcmp(argv[2], "bt") == 0){
-			useWeighted(BT);
-		}
-		else if(strcmp(argv[2], "mst") == 0){
-			useWeighted(MST);
-		}
-		else printUsage();
+		else if(!runBenchmark(defaultBenchmark(mode, argv[2])))
+			return EXIT_FAILURE;
 	}
 	else{
 		printUsage();		